@@ -0,0 +1,44 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+//! Interrupt enable bit of the supervision register, cleared to mask the handlers pushing events
+#define SR_IEE (1 << 2)
+
+//! Number of events the queue holds, consecutive presses of a kind share one
+#define INPUT_QUEUE_SIZE 8
+
+//! \brief Kinds of input events
+enum input_kind {
+  INPUT_PAN,       //!< joystick, moves the view
+  INPUT_ZOOM_IN,   //!< SW1, halves the step around the center
+  INPUT_ZOOM_OUT,  //!< SW2, doubles the step around the center
+  INPUT_RESET,     //!< SW3, back to the initial view
+};
+
+//! \brief Input event, pushed by the interrupt handler
+struct input_event {
+  enum input_kind kind;
+  int32_t dx, dy;           //!< pixels of an INPUT_PAN
+  uint32_t presses;         //!< presses coalesced in the event
+  uint32_t irq_latency;     //!< IRQ_LATENCY_ID of the switches at the latest press
+  uint32_t tick;            //!< tick timer count when the latest press was handled
+};
+
+//! \brief Queues an event, or merges it into the last one if it has the same kind.
+//!        Called by the interrupt handler.
+//! \return 0 if the queue is full, the event is dropped
+int input_push(const struct input_event *event);
+
+//! \brief Takes the oldest event, with the external interrupts masked
+//! \return 0 if the queue is empty
+int input_pop(struct input_event *event);
+
+//! \brief Tells whether events are queued, the cancellation flag of the render task
+int input_pending();
+
+//! \brief Number of events dropped because the queue was full
+uint32_t input_dropped();
+
+#endif // INPUT_H
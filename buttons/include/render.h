@@ -0,0 +1,65 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdint.h>
+#include <perf.h>
+
+// Constants describing the output device
+#define SCREEN_WIDTH 512   //!< screen width
+#define SCREEN_HEIGHT 512  //!< screen height
+
+//! \brief View of the fractal: top-left point and step between pixels, in Q4.28
+struct render_view {
+  uint32_t cx, cy, delta;
+  uint16_t n_max;
+};
+
+//! \brief Renders the rectangle at (x0, y0) of the frame buffer with the custom instruction
+//! \note  The instruction computes two pixels at once: x0 and width must be even.
+//!        The D$ is not flushed.
+void render_rect(uint32_t *fbuf, const struct render_view *view, int x0, int y0, int width, int height);
+
+//! \brief Renders the whole frame and writes it back for the VGA
+void render_frame(uint32_t *fbuf, const struct render_view *view);
+
+//! \brief Renders a frame panned from `drawn` to `view`
+//!
+//! The pixels of `drawn` still visible in `view` are moved (whole rows by DMA) and only
+//! the exposed strips are computed.
+//! \return 0 if the views are not an even number of pixels apart horizontally and a
+//!         whole number vertically (or differ in zoom), the frame buffer is left as is
+int render_pan(uint32_t *fbuf, const struct render_view *drawn, const struct render_view *view);
+
+//! Sample step of the first, coarsest, level of the progressive rendering
+#define RENDER_COARSE_STEP 8
+
+//! Number of levels of the progressive rendering: steps 8, 4, 2 and 1
+#define RENDER_LEVELS 4
+
+//! \brief Progressive rendering of a frame, run a row at a time by the main loop
+struct render_task {
+  uint32_t *fbuf;
+  struct render_view view;
+  int step;  //!< sample step of the current level, 0 once the frame is complete
+  int y;     //!< next row of the level
+};
+
+//! \brief Starts rendering a frame coarse to fine, see render_progressive
+void render_task_start(struct render_task *task, uint32_t *fbuf, const struct render_view *view);
+
+//! \brief Renders the next row of the task, and writes the frame back at the end of a level
+//! \note  The caller cancels the task by not stepping it anymore.
+//! \return 0 once the frame is complete
+int render_task_step(struct render_task *task);
+
+//! \brief Renders the frame coarse to fine, one sample every 8, 4, 2 and then every pixel
+//!
+//! Each level computes the samples the previous ones did not, fills the block of each
+//! sample with its colour and writes the frame back, so that the VGA shows it.
+//! \param abort        polled between rows, the rendering stops when it is set
+//! \param level_cycles if not NULL, runtime counter at the end of each level
+//! \return             number of levels rendered, RENDER_LEVELS if the frame is complete
+int render_progressive(uint32_t *fbuf, const struct render_view *view, volatile uint32_t *abort,
+                       perf_cycles_t *level_cycles);
+
+#endif // RENDER_H
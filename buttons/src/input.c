@@ -0,0 +1,56 @@
+#include <input.h>
+#include <spr.h>
+
+//! Queue of the events, written by the interrupt handler and read by the main loop
+static struct {
+  struct input_event events[INPUT_QUEUE_SIZE];
+  volatile uint32_t head;  //!< next event to take
+  volatile uint32_t tail;  //!< next free entry
+  uint32_t dropped;
+} queue;
+
+int input_push(const struct input_event *event) {
+  /* the main loop only takes events with the interrupts masked, the last one can be merged */
+  if (queue.tail != queue.head) {
+    struct input_event *last = &queue.events[(queue.tail - 1) % INPUT_QUEUE_SIZE];
+    if (last->kind == event->kind) {
+      last->dx += event->dx;
+      last->dy += event->dy;
+      last->presses += event->presses;
+      last->irq_latency = event->irq_latency;
+      last->tick = event->tick;
+      return 1;
+    }
+  }
+
+  if (queue.tail - queue.head == INPUT_QUEUE_SIZE) {
+    queue.dropped++;
+    return 0;
+  }
+
+  queue.events[queue.tail % INPUT_QUEUE_SIZE] = *event;
+  queue.tail++;
+  return 1;
+}
+
+int input_pop(struct input_event *event) {
+  uint32_t sr = SPR_READ(SPR_SR);
+  SPR_WRITE(SPR_SR, sr & ~SR_IEE);
+
+  int taken = queue.head != queue.tail;
+  if (taken) {
+    *event = queue.events[queue.head % INPUT_QUEUE_SIZE];
+    queue.head++;
+  }
+
+  SPR_WRITE(SPR_SR, sr);
+  return taken;
+}
+
+int input_pending() {
+  return queue.head != queue.tail;
+}
+
+uint32_t input_dropped() {
+  return queue.dropped;
+}
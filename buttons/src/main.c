@@ -1,15 +1,15 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <binlog.h>
 #include <cache.h>
 #include <vga.h>
 #include <switches.h>
 #include <swap.h>
 #include <defs.h>
 #include <perf.h>
-
-// Constants describing the output device
-#define SCREEN_WIDTH 512   //!< screen width
-#define SCREEN_HEIGHT 512  //!< screen height
+#include <render.h>
+#include <input.h>
+#include <tickTimer.h>
 
 // Constants describing the initial view port on the fractal function
 const uint32_t FRAC_WIDTH = 0x30000000; 
@@ -17,28 +17,138 @@ const uint32_t CX_0 = 0xe0000000;
 const uint32_t CY_0 = 0xe8000000;       
 const uint16_t N_MAX = 64;              
 
+// Joystick directions in the buttons state, they pan the view
+#define JOYSTICK_WEST (1 << 24)
+#define JOYSTICK_SOUTH (1 << 25)
+#define JOYSTICK_EAST (1 << 26)
+#define JOYSTICK_NORTH (1 << 27)
+#define JOYSTICK_PAN_MASK (JOYSTICK_WEST | JOYSTICK_SOUTH | JOYSTICK_EAST | JOYSTICK_NORTH)
+
+// Buttons in the buttons state: SW1 zooms in, SW2 zooms out and SW3 resets the view
+#define BUTTON_SW1 (1 << 29)
+#define BUTTON_SW2 (1 << 30)
+#define BUTTON_SW3 (1 << 31)
+#define BUTTON_VIEW_MASK (BUTTON_SW1 | BUTTON_SW2 | BUTTON_SW3)
+
+//! Largest step between pixels, zooming out further would overflow Q4.28
+#define DELTA_MAX (4 * (FRAC_WIDTH / SCREEN_WIDTH))
+
+//! Pixels panned per joystick press, even as the custom instruction computes pixel pairs
+#define PAN_PIXELS 16
+
 // global variables indicating the zoom factor and x- and y- offset for the fractal
-volatile uint32_t delta, cxOff, cyOff, redraw;
+uint32_t delta, cxOff, cyOff;
 uint32_t frameBuffer[(SCREEN_WIDTH * SCREEN_HEIGHT)/2];
 
+// view of the frame buffer content, valid once a frame is drawn
+struct render_view drawnView;
+int drawnValid;
+
+struct render_view currentView() {
+  struct render_view view = { CX_0 + cxOff, CY_0 + cyOff, delta, N_MAX };
+  return view;
+}
+
+//! \brief Draws the current view, moving the pixels of the last frame if it is a pan of it
+//!        and coarse to fine otherwise
+//! \return cycles of the frame
+perf_cycles_t drawFractal(uint32_t *frameBuffer) {
+  struct render_view view = currentView();
+  volatile uint32_t never = 0;
+  perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+  int panned = drawnValid && render_pan(frameBuffer, &drawnView, &view);
+  int levels = RENDER_LEVELS;
+  if (!panned)
+    levels = render_progressive(frameBuffer, &view, &never, NULL);
+  perf_cycles_t cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+  drawnView = view;
+  drawnValid = levels == RENDER_LEVELS;
+  printf("frame,%s,%llu\n", panned ? "pan" : drawnValid ? "full" : "aborted", cycles);
+  return cycles;
+}
 
-void drawFractal(uint32_t *frameBuffer) {
-  printf("Starting drawing a fractal\n");
-  uint32_t color = (2<<16) | N_MAX;
-  uint32_t * pixels = frameBuffer;
-  asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(color),[in2]"r"(delta));
-  uint32_t cy = CY_0 + cyOff;
-  for (int k = 0 ; k < SCREEN_HEIGHT ; k++) {
-    uint32_t cx = CX_0 + cxOff;
-    for (int i = 0 ; i < SCREEN_WIDTH ; i+=2) {
-      asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
-      *(pixels++) = color;
-      cx += delta << 1;
+//! \brief Applies an input to the view, zooms keep the center of the screen
+void applyInput(const struct input_event *event) {
+  switch (event->kind) {
+  case INPUT_PAN:
+    cxOff += event->dx * delta;
+    cyOff += event->dy * delta;
+    break;
+  case INPUT_ZOOM_IN:
+  case INPUT_ZOOM_OUT:
+    for (uint32_t p = 0; p < event->presses; p++) {
+      uint32_t next = event->kind == INPUT_ZOOM_IN ? delta >> 1 : delta << 1;
+      if (next == 0 || next > DELTA_MAX)
+        break;
+      cxOff += (delta - next) * (SCREEN_WIDTH / 2);
+      cyOff += (delta - next) * (SCREEN_HEIGHT / 2);
+      delta = next;
     }
-    cy += delta;
+    break;
+  case INPUT_RESET:
+    delta = FRAC_WIDTH / SCREEN_WIDTH;
+    cxOff = 0;
+    cyOff = 0;
+    break;
   }
-  dcache_flush();
-  printf("Done\n");
+}
+
+//! \brief Starts drawing the current view, cancelling the frame in progress
+//!
+//! A pan of the last complete frame is drawn at once, the task is then complete.
+void startFrame(struct render_task *task) {
+  struct render_view view = currentView();
+  if (drawnValid && render_pan(frameBuffer, &drawnView, &view)) {
+    drawnView = view;
+    task->step = 0;
+    return;
+  }
+  drawnValid = 0;
+  render_task_start(task, frameBuffer, &view);
+}
+
+//! \brief Times the progressive rendering against the single pass, from the initial view
+void progressiveBenchmark() {
+  struct render_view view = currentView();
+  perf_cycles_t levels[RENDER_LEVELS];
+  volatile uint32_t never = 0;
+
+  perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+  render_frame(frameBuffer, &view);
+  perf_cycles_t single = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+  start = perf_read_counter(PERF_COUNTER_RUNTIME);
+  render_progressive(frameBuffer, &view, &never, levels);
+
+  // the first level is the time to the first image, the last one the total
+  printf("progressive,step,cycles,single_pass_cycles\n");
+  for (int l = 0; l < RENDER_LEVELS; l++)
+    printf("progressive,%d,%llu,%llu\n", RENDER_COARSE_STEP >> l, levels[l] - start, single);
+
+  // the frame buffer holds the initial view, the first interactive frame may pan it
+  drawnView = view;
+  drawnValid = 1;
+}
+
+//! \brief Times pans of a few pixels against the full frame, from the initial view
+void panBenchmark() {
+  static const int pans[][2] = { {2, 0}, {0, 1}, {0, -1}, {16, 0}, {-16, 0}, {0, 16}, {16, 16}, {-64, -64} };
+
+  printf("pan,dx,dy,cycles,full_cycles\n");
+  for (unsigned p = 0; p < sizeof(pans) / sizeof(pans[0]); p++) {
+    cxOff = 0;
+    cyOff = 0;
+    drawnValid = 0;
+    perf_cycles_t full = drawFractal(frameBuffer);
+
+    cxOff = pans[p][0] * delta;
+    cyOff = pans[p][1] * delta;
+    perf_cycles_t cycles = drawFractal(frameBuffer);
+    printf("pan,%d,%d,%llu,%llu\n", pans[p][0], pans[p][1], cycles, full);
+  }
+  cxOff = 0;
+  cyOff = 0;
 }
 
 void dipswitch_handler(){
@@ -47,18 +157,40 @@ void dipswitch_handler(){
   volatile uint32_t ouioui = *(switches + DIP_SWITCH_PRESSED_IRQ_ID);
 }
 
-void buttons_handler(){
+//! \brief Tick timer count, which keeps running through the exception exits of crt0 that
+//!        stop the performance counters. Wraps every 2^28 cycles.
+static inline uint32_t tickNow() {
+  return SPR_READ(TICK_TIMER_COUNT_REGISTER) & TICK_TIME_PERIOD_MASK;
+}
+
+//! \brief Queues an input, stamped with the latency and the time of the press
+void pushInput(enum input_kind kind, int32_t dx, int32_t dy) {
   volatile uint32_t * switches = (uint32_t *) SWITCHES_BASE_ADDRESS;
-  puts("buttons handler");
-  printf("Latency : %u \n", *(switches+IRQ_LATENCY_ID));
-  redraw = 1;
+  struct input_event event = { kind, dx, dy, 1, *(switches + IRQ_LATENCY_ID), tickNow() };
+  if (!input_push(&event))
+    BINLOG("input dropped %u\n", kind);
+}
+
+void buttons_handler(uint32_t sw_joystick){
+  volatile uint32_t * switches = (uint32_t *) SWITCHES_BASE_ADDRESS;
+  // formatted on the host by support/tools/binlog.py, printing would delay the handler
+  BINLOG("buttons handler %x\n", sw_joystick);
+  if (sw_joystick & BUTTON_SW1) pushInput(INPUT_ZOOM_IN, 0, 0);
+  else if (sw_joystick & BUTTON_SW2) pushInput(INPUT_ZOOM_OUT, 0, 0);
+  else if (sw_joystick & BUTTON_SW3) pushInput(INPUT_RESET, 0, 0);
   volatile uint32_t ouioui = *(switches + BUTTONS_PRESSED_IRQ_ID);
 
 }
 
-void joystick_handler(){
+void joystick_handler(uint32_t sw_joystick){
   uint32_t * switches = (uint32_t *) SWITCHES_BASE_ADDRESS;
-  puts("joystick handler");
+  int32_t dx = 0, dy = 0;
+  BINLOG("joystick handler %x\n", sw_joystick);
+  if (sw_joystick & JOYSTICK_WEST) dx -= PAN_PIXELS;
+  if (sw_joystick & JOYSTICK_EAST) dx += PAN_PIXELS;
+  if (sw_joystick & JOYSTICK_NORTH) dy -= PAN_PIXELS;
+  if (sw_joystick & JOYSTICK_SOUTH) dy += PAN_PIXELS;
+  pushInput(INPUT_PAN, dx, dy);
   uint32_t ouioui = *(switches + BUTTONS_PRESSED_IRQ_ID);
 }
 
@@ -71,11 +203,11 @@ void external_interrupt_handler(){
   }
   //Comes from a button 1 << 29,30,31,16,17
   else if (sw_joystick & 0xe0030000){
-    buttons_handler();
+    buttons_handler(sw_joystick);
   }
   //Comes from the joystick
   else if (sw_joystick & 0x1f000000){
-    joystick_handler();
+    joystick_handler(sw_joystick);
   }
   else{
     return;
@@ -91,6 +223,7 @@ int main() {
   icache_enable(1);
   dcache_enable(1);
   perf_init();
+  perf_start();
 
   volatile unsigned int *vga = (unsigned int *) 0X50000020;
   uint32_t * switches = (uint32_t *) SWITCHES_BASE_ADDRESS;
@@ -106,7 +239,9 @@ int main() {
   delta = FRAC_WIDTH / SCREEN_WIDTH;
   cxOff = 0;
   cyOff = 0;
-  redraw = 1;
+
+  panBenchmark();
+  progressiveBenchmark();
 
   // From left to right dip switches : 1000000, 2000000, 4000000, 8000000, 10000000, 20000000, 40000000, 80000000 
   // From SW1 to SW5 : 20000000, 40000000, 80000000, 10000, 200000
@@ -139,16 +274,47 @@ int main() {
   picmr = SPR_READ(SPR_PICMR);
   printf("picmr is %x \n", picmr);
 
+  // Free-running tick timer, the time base of the input latency
+  setTickTimerModeRegister(TICK_TIMER_CONTINUES_MODE | TICK_TIME_PERIOD_MASK);
+  clearTickTimerCountRegister();
+
   // Write IRQ masks
   *(switches+DIP_SWITCH_PRESSED_IRQ_ID) = (1 << 24);
-  *(switches+BUTTONS_PRESSED_IRQ_ID) = (1 << 30);
+  *(switches+BUTTONS_PRESSED_IRQ_ID) = BUTTON_VIEW_MASK | JOYSTICK_PAN_MASK;
+
+  // The frame is rendered a row at a time, the queue is checked between rows so that
+  // the frame of the latest input starts within one row of it
+  struct render_task task;
+  struct input_event event;
 
+  startFrame(&task);
+  printf("latency,irq_latency,irq_to_first_row_cycles,press_to_first_row_cycles,presses\n");
   do {
-    if (redraw == 1) {
-      redraw = 0;
-      printf("OUI \n");
-      perf_print_cycles(PERF_COUNTER_RUNTIME, "irq runtime");
-      drawFractal(frameBuffer);
+    if (input_pending()) {
+      uint32_t presses = 0;
+      while (input_pop(&event)) {
+        applyInput(&event);
+        presses += event.presses;
+      }
+
+      startFrame(&task);
+      if (task.step)
+        render_task_step(&task);
+
+      // event holds the latest input: the one the frame is drawn for. From its handler to the
+      // first row: the row in progress, the drain and the first row of the new frame.
+      uint32_t toFirstRow = (tickNow() - event.tick) & TICK_TIME_PERIOD_MASK;
+
+      // the handlers BINLOG, the log is flushed before they run again
+      sr = SPR_READ(SPR_SR);
+      SPR_WRITE(SPR_SR, sr & ~SR_IEE);
+      binlog_flush();
+      SPR_WRITE(SPR_SR, sr);
+
+      printf("latency,%u,%u,%u,%u\n", event.irq_latency, toFirstRow, event.irq_latency + toFirstRow, presses);
+    } else if (render_task_step(&task) == 0 && !drawnValid) {
+      drawnView = task.view;
+      drawnValid = 1;
     }
 
     // // Polling on dip switch buttons
@@ -0,0 +1,171 @@
+#include <render.h>
+#include <cache.h>
+#include <dma_copy.h>
+#include <string.h>
+
+//! Words of a row, the frame buffer packs two pixels per word
+#define ROW_WORDS (SCREEN_WIDTH / 2)
+
+void render_rect(uint32_t *fbuf, const struct render_view *view, int x0, int y0, int width, int height) {
+  uint32_t color = (2<<16) | view->n_max;
+  asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(color),[in2]"r"(view->delta));
+  uint32_t cy = view->cy + y0 * view->delta;
+  for (int k = 0 ; k < height ; k++) {
+    uint32_t *pixels = fbuf + (y0 + k) * ROW_WORDS + x0 / 2;
+    uint32_t cx = view->cx + x0 * view->delta;
+    for (int i = 0 ; i < width ; i+=2) {
+      asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
+      *(pixels++) = color;
+      cx += view->delta << 1;
+    }
+    cy += view->delta;
+  }
+}
+
+void render_frame(uint32_t *fbuf, const struct render_view *view) {
+  render_rect(fbuf, view, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+  dcache_flush();
+}
+
+//! \brief Offset in pixels of `view` from `drawn` along one axis
+//! \return 0 if it is not a whole number of pixels
+static int pixel_offset(uint32_t from, uint32_t to, uint32_t delta, int32_t *offset) {
+  int32_t diff = (int32_t)(to - from);
+  *offset = diff / (int32_t)delta;
+  return *offset * (int32_t)delta == diff;
+}
+
+//! \brief Moves the rows of the frame by dy rows: row y becomes row y - dy
+//! \note  dma_memcpy does not take overlapping buffers, so the rows move in blocks of at most
+//!        |dy| rows, which do not overlap their destination, in the order that reads each
+//!        block before it is overwritten.
+static void move_rows(uint32_t *fbuf, int dy) {
+  int rows = SCREEN_HEIGHT - (dy > 0 ? dy : -dy);
+  if (dy > 0) {
+    /* moving up, blocks from the top */
+    for (int start = 0; start < rows; start += dy) {
+      int end = start + dy < rows ? start + dy : rows;
+      dma_memcpy(fbuf + start * ROW_WORDS, fbuf + (start + dy) * ROW_WORDS, (end - start) * ROW_WORDS * 4);
+    }
+    return;
+  }
+
+  /* moving down, blocks from the bottom */
+  for (int end = rows; end > 0; end += dy) {
+    int start = end + dy > 0 ? end + dy : 0;
+    dma_memcpy(fbuf + (start - dy) * ROW_WORDS, fbuf + start * ROW_WORDS, (end - start) * ROW_WORDS * 4);
+  }
+}
+
+int render_pan(uint32_t *fbuf, const struct render_view *drawn, const struct render_view *view) {
+  int32_t dx, dy;
+
+  if (view->delta != drawn->delta || view->n_max != drawn->n_max
+      || !pixel_offset(drawn->cx, view->cx, view->delta, &dx)
+      || !pixel_offset(drawn->cy, view->cy, view->delta, &dy)
+      || (dx & 1) || dx <= -SCREEN_WIDTH || dx >= SCREEN_WIDTH || dy <= -SCREEN_HEIGHT || dy >= SCREEN_HEIGHT)
+    return 0;
+
+  if (dy)
+    move_rows(fbuf, dy);
+
+  /* rows still visible, and where they are now */
+  int kept_y = dy > 0 ? 0 : -dy;
+  int kept_rows = SCREEN_HEIGHT - (dy > 0 ? dy : -dy);
+
+  if (dx) {
+    int kept_words = ROW_WORDS - (dx > 0 ? dx : -dx) / 2;
+    for (int k = kept_y; k < kept_y + kept_rows; k++) {
+      uint32_t *row = fbuf + k * ROW_WORDS;
+      if (dx > 0)
+        memmove(row, row + dx / 2, kept_words * 4);
+      else
+        memmove(row - dx / 2, row, kept_words * 4);
+    }
+  }
+
+  /* exposed strips: full rows, then the columns of the kept rows */
+  if (dy > 0)
+    render_rect(fbuf, view, 0, kept_rows, SCREEN_WIDTH, dy);
+  else if (dy < 0)
+    render_rect(fbuf, view, 0, 0, SCREEN_WIDTH, -dy);
+
+  if (dx > 0)
+    render_rect(fbuf, view, SCREEN_WIDTH - dx, kept_y, dx, kept_rows);
+  else if (dx < 0)
+    render_rect(fbuf, view, 0, kept_y, -dx, kept_rows);
+
+  dcache_flush();
+  return 1;
+}
+
+//! \brief Fills the step x step block of the sample at (x, y)
+static void fill_block(uint32_t *fbuf, int x, int y, int step, uint16_t colour) {
+  /* 16-bit stores: the first pixel of a word is its high half (big endian) */
+  uint16_t *row = (uint16_t *)fbuf + y * SCREEN_WIDTH + x;
+  for (int k = 0; k < step; k++, row += SCREEN_WIDTH)
+    for (int i = 0; i < step; i++)
+      row[i] = colour;
+}
+
+//! \brief Computes the samples of row y of a level that the coarser levels did not compute
+static void render_level_row(uint32_t *fbuf, const struct render_view *view, int step, int y) {
+  uint32_t color;
+
+  /* the rows of the coarser level only miss their odd multiples of step */
+  int coarse_row = step != RENDER_COARSE_STEP && (y & (2 * step - 1)) == 0;
+  int x0 = coarse_row ? step : 0;
+  int spacing = coarse_row ? 2 * step : step;
+
+  /* the instruction computes the samples at cx and cx + spacing */
+  color = (2<<16) | view->n_max;
+  asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(color),[in2]"r"(view->delta * spacing));
+
+  uint32_t cy = view->cy + y * view->delta;
+  uint32_t cx = view->cx + x0 * view->delta;
+  for (int x = x0; x < SCREEN_WIDTH; x += 2 * spacing) {
+    asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
+    fill_block(fbuf, x, y, step, color >> 16);
+    fill_block(fbuf, x + spacing, y, step, color & 0xffff);
+    cx += (view->delta * spacing) << 1;
+  }
+}
+
+void render_task_start(struct render_task *task, uint32_t *fbuf, const struct render_view *view) {
+  task->fbuf = fbuf;
+  task->view = *view;
+  task->step = RENDER_COARSE_STEP;
+  task->y = 0;
+}
+
+int render_task_step(struct render_task *task) {
+  if (!task->step)
+    return 0;
+
+  render_level_row(task->fbuf, &task->view, task->step, task->y);
+  task->y += task->step;
+  if (task->y == SCREEN_HEIGHT) {
+    dcache_flush();
+    task->step >>= 1;
+    task->y = 0;
+  }
+  return task->step != 0;
+}
+
+int render_progressive(uint32_t *fbuf, const struct render_view *view, volatile uint32_t *abort,
+                       perf_cycles_t *level_cycles) {
+  struct render_task task;
+  int level = 0;
+
+  render_task_start(&task, fbuf, view);
+  while (task.step && !*abort) {
+    int step = task.step;
+    render_task_step(&task);
+    if (task.step != step) {
+      if (level_cycles)
+        level_cycles[level] = perf_read_counter(PERF_COUNTER_RUNTIME);
+      level++;
+    }
+  }
+  return level;
+}
@@ -0,0 +1,41 @@
+#ifndef PATTERNS_H_INCLUDED
+#define PATTERNS_H_INCLUDED
+
+#include <stdint.h>
+
+/// @brief Number of CPUs taking part in each pattern (CPU 1 and CPU 2).
+#define PATTERN_NUM_CPUS 2
+
+/// @brief Number of iterations of each pattern, per CPU.
+#define PATTERN_ITERATIONS 1024
+
+/// @brief Assumed D$ line size, used to pad the shared variables.
+#define PATTERN_LINE_SIZE 32
+
+/**
+ * @brief Canonical sharing pattern, run concurrently by both CPUs.
+ *
+ */
+struct pattern {
+    /** @brief Name of the pattern. */
+    const char* name;
+
+    /**
+     * @brief Resets the shared data. Called by CPU 1 while CPU 2 is idle.
+     *
+     */
+    void (*reset)();
+
+    /**
+     * @brief Runs the pattern.
+     *
+     * @param cpu Index of the CPU taking part, from 0 to `PATTERN_NUM_CPUS - 1`.
+     */
+    void (*run)(uint32_t cpu);
+};
+
+extern const struct pattern patterns[];
+
+extern const unsigned pattern_count;
+
+#endif /* PATTERNS_H_INCLUDED */
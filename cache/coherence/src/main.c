@@ -0,0 +1,146 @@
+#include <cache.h>
+#include <cpu2.h>
+#include <defs.h>
+#include <perf.h>
+#include <platform.h>
+#include <stdio.h>
+
+#include <patterns.h>
+
+#define DCACHE_BASE_CFG (CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK | CACHE_COHERENCE)
+
+#define MISS_COUNTER PERF_COUNTER_0
+#define INVAL_COUNTER PERF_COUNTER_1
+
+static const struct {
+    const char* name;
+    uint32_t cfg;
+} configs[] = {
+    { .name = "msi", .cfg = DCACHE_BASE_CFG | CACHE_MSI },
+    { .name = "msi_snarf", .cfg = DCACHE_BASE_CFG | CACHE_MSI | CACHE_SNARFING_ENABLE },
+    { .name = "mesi", .cfg = DCACHE_BASE_CFG | CACHE_MESI },
+    { .name = "mesi_snarf", .cfg = DCACHE_BASE_CFG | CACHE_MESI | CACHE_SNARFING_ENABLE },
+};
+
+struct result {
+    perf_cycles_t cycles;
+    perf_cycles_t dcache_misses;
+    perf_cycles_t snoopy_invals;
+};
+
+/**
+ * @brief Commands sent by CPU 1 to CPU 2.
+ *
+ * @note `go` and `done` are sequence numbers: CPU 2 runs the command when
+ * `go` changes and publishes `done = go` once finished.
+ *
+ */
+__global static struct {
+    volatile uint32_t go __aligned(32);
+    volatile uint32_t cfg;
+    volatile uint32_t pattern;
+    volatile uint32_t ready __aligned(32);
+    volatile uint32_t done __aligned(32);
+    struct result result;
+} command;
+
+static void configure(uint32_t cfg) {
+    dcache_flush();
+    dcache_write_cfg(cfg);
+    dcache_enable(1);
+}
+
+static void run(uint32_t cpu, const struct pattern* pattern, struct result* result) {
+    perf_cycles_t cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+    perf_cycles_t misses = perf_read_counter(MISS_COUNTER);
+    perf_cycles_t invals = perf_read_counter(INVAL_COUNTER);
+
+    pattern->run(cpu);
+
+    result->cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - cycles;
+    result->dcache_misses = perf_read_counter(MISS_COUNTER) - misses;
+    result->snoopy_invals = perf_read_counter(INVAL_COUNTER) - invals;
+}
+
+static void perf_setup() {
+    perf_set_mask(MISS_COUNTER, PERF_DCACHE_MISS_MASK);
+    perf_set_mask(INVAL_COUNTER, PERF_DCACHE_SNOOPY_INVAL_MASK);
+    perf_start();
+}
+
+void main2() {
+    uint32_t seq = 0;
+    uint32_t cfg = 0;
+
+    perf_setup();
+
+    while (1) {
+        while (command.go == seq)
+            ;
+        seq = command.go;
+
+        if (command.cfg != cfg) {
+            cfg = command.cfg;
+            configure(cfg);
+        }
+
+        /* both CPUs enter the pattern at the same time */
+        command.ready = seq;
+        while (command.ready != 0)
+            ;
+
+        run(1, &patterns[command.pattern], &command.result);
+        command.done = seq;
+    }
+}
+
+int main() {
+    platform_init();
+    perf_init();
+
+    perf_setup();
+    dcache_write_cfg(configs[0].cfg);
+    dcache_enable(1);
+
+    command.go = 0;
+    command.ready = 0;
+    command.done = 0;
+
+    SET_CPU2_MAIN(&init_cpu2);
+    set_stack_cpu2(1ull << 20 /* 1 MB*/);
+    START_CPU2();
+
+    uint32_t seq = 0;
+
+    printf("config,pattern,cpu,cycles,dcache_misses,snoopy_invals\n");
+
+    for (unsigned c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        configure(configs[c].cfg);
+
+        for (unsigned p = 0; p < pattern_count; p++) {
+            struct result result;
+
+            patterns[p].reset();
+
+            command.cfg = configs[c].cfg;
+            command.pattern = p;
+            command.go = ++seq;
+
+            while (command.ready != seq)
+                ;
+            command.ready = 0;
+
+            run(0, &patterns[p], &result);
+
+            while (command.done != seq)
+                ;
+
+            printf("%s,%s,1,%llu,%llu,%llu\n", configs[c].name, patterns[p].name,
+                   result.cycles, result.dcache_misses, result.snoopy_invals);
+            printf("%s,%s,2,%llu,%llu,%llu\n", configs[c].name, patterns[p].name,
+                   command.result.cycles, command.result.dcache_misses, command.result.snoopy_invals);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <defs.h>
+#include <patterns.h>
+
+#define RING_SIZE 16
+#define TABLE_SIZE 64
+#define TABLE_WRITE_PERIOD 64
+
+#pragma region "Per-core counters"
+
+/* both counters share one D$ line: every increment invalidates the other CPU's copy */
+__global static volatile uint32_t packed_counters[PATTERN_NUM_CPUS] __aligned(PATTERN_LINE_SIZE);
+
+/* one D$ line per counter */
+__global static struct {
+    volatile uint32_t value __aligned(PATTERN_LINE_SIZE);
+} padded_counters[PATTERN_NUM_CPUS];
+
+static void counters_reset() {
+    for (int i = 0; i < PATTERN_NUM_CPUS; i++) {
+        packed_counters[i] = 0;
+        padded_counters[i].value = 0;
+    }
+}
+
+static void counters_packed_run(uint32_t cpu) {
+    for (int i = 0; i < PATTERN_ITERATIONS; i++)
+        packed_counters[cpu]++;
+}
+
+static void counters_padded_run(uint32_t cpu) {
+    for (int i = 0; i < PATTERN_ITERATIONS; i++)
+        padded_counters[cpu].value++;
+}
+
+#pragma endregion
+
+#pragma region "Producer/consumer ring"
+
+__global static struct {
+    volatile uint32_t head __aligned(PATTERN_LINE_SIZE);
+    volatile uint32_t tail __aligned(PATTERN_LINE_SIZE);
+    volatile uint32_t data[RING_SIZE] __aligned(PATTERN_LINE_SIZE);
+    volatile uint32_t sum __aligned(PATTERN_LINE_SIZE);
+} ring;
+
+static void ring_reset() {
+    ring.head = 0;
+    ring.tail = 0;
+    ring.sum = 0;
+}
+
+static void ring_run(uint32_t cpu) {
+    if (cpu == 0) {
+        /* producer */
+        for (uint32_t i = 0; i < PATTERN_ITERATIONS; i++) {
+            uint32_t tail = ring.tail;
+            while (tail - ring.head == RING_SIZE)
+                ;
+            ring.data[tail % RING_SIZE] = i;
+            ring.tail = tail + 1;
+        }
+    } else {
+        /* consumer */
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < PATTERN_ITERATIONS; i++) {
+            uint32_t head = ring.head;
+            while (head == ring.tail)
+                ;
+            sum += ring.data[head % RING_SIZE];
+            ring.head = head + 1;
+        }
+        ring.sum = sum;
+    }
+}
+
+#pragma endregion
+
+#pragma region "Read-mostly table"
+
+__global static volatile uint32_t table[TABLE_SIZE] __aligned(PATTERN_LINE_SIZE);
+
+__global static volatile uint32_t table_sums[PATTERN_NUM_CPUS] __aligned(PATTERN_LINE_SIZE);
+
+static void table_reset() {
+    for (int i = 0; i < TABLE_SIZE; i++)
+        table[i] = i;
+}
+
+static void table_run(uint32_t cpu) {
+    uint32_t sum = 0;
+
+    for (int i = 0; i < PATTERN_ITERATIONS; i++) {
+        sum += table[i % TABLE_SIZE];
+
+        /* CPU 1 occasionally updates an entry */
+        if (cpu == 0 && i % TABLE_WRITE_PERIOD == 0)
+            table[(i / TABLE_WRITE_PERIOD) % TABLE_SIZE] = sum;
+    }
+
+    table_sums[cpu] = sum;
+}
+
+#pragma endregion
+
+#pragma region "Migratory lock"
+
+/* the lock and the data it protects move together from one D$ to the other */
+__global static struct {
+    volatile uint32_t lock;
+    volatile uint32_t a;
+    volatile uint32_t b;
+} migratory __aligned(PATTERN_LINE_SIZE);
+
+static void migratory_reset() {
+    migratory.lock = 0;
+    migratory.a = 0;
+    migratory.b = 0;
+}
+
+static void migratory_run(uint32_t cpu) {
+    uint32_t owner = cpu + 1;
+    uint32_t res;
+
+    for (int i = 0; i < PATTERN_ITERATIONS; i++) {
+        /* same protocol as `get_lock`, on a cacheable word */
+        do {
+            asm volatile(
+                "l.cas %[out1],%[in1],%[in2],0" :
+                [out1] "=r"(res) :
+                [in1] "r"(&migratory.lock),
+                [in2] "r"(owner)
+            );
+        } while (res != owner);
+
+        migratory.a++;
+        migratory.b += migratory.a;
+
+        migratory.lock = 0;
+    }
+}
+
+#pragma endregion
+
+const struct pattern patterns[] = {
+    { .name = "counters_packed", .reset = &counters_reset, .run = &counters_packed_run },
+    { .name = "counters_padded", .reset = &counters_reset, .run = &counters_padded_run },
+    { .name = "ring", .reset = &ring_reset, .run = &ring_run },
+    { .name = "read_mostly", .reset = &table_reset, .run = &table_run },
+    { .name = "migratory_lock", .reset = &migratory_reset, .run = &migratory_run },
+};
+
+const unsigned pattern_count = sizeof(patterns) / sizeof(patterns[0]);
@@ -0,0 +1 @@
+../../../fractal_fxpt_sol/include/fractal_fxpt.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../tasks/include/node.h
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef WORKLOADS_H_INCLUDED
+#define WORKLOADS_H_INCLUDED
+
+#include <stdint.h>
+
+/**
+ * @brief Workload run at each point of the sweep.
+ *
+ */
+struct workload {
+    /** @brief Name of the workload. */
+    const char* name;
+
+    /**
+     * @brief Prepares the data. Not measured.
+     *
+     */
+    void (*init)();
+
+    /**
+     * @brief Measured part of the workload.
+     *
+     * @return uint32_t Checksum, identical at every point of the sweep.
+     */
+    uint32_t (*run)();
+};
+
+extern const struct workload workloads[];
+
+extern const unsigned workload_count;
+
+#endif /* WORKLOADS_H_INCLUDED */
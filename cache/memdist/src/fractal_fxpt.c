@@ -0,0 +1 @@
+../../../fractal_fxpt_sol/src/fractal_fxpt.c
\ No newline at end of file
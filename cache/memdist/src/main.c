@@ -0,0 +1,103 @@
+#include <cache.h>
+#include <perf.h>
+#include <perf_session.h>
+#include <platform.h>
+#include <stdio.h>
+
+#include <workloads.h>
+
+/// @brief Memory distances of the sweep, see `perf_memdist_set`.
+static const uint32_t memdists[] = { 0, 2, 5, 10, 25, 63 };
+
+#define MEMDIST_COUNT (sizeof(memdists) / sizeof(memdists[0]))
+
+static const struct {
+    const char* name;
+    int enable;
+    uint32_t cfg;
+} configs[] = {
+    { .name = "off", .enable = 0, .cfg = 0 },
+    { .name = "dm_1k_wt", .enable = 1, .cfg = CACHE_DIRECT_MAPPED | CACHE_SIZE_1K | CACHE_WRITE_THROUGH },
+    { .name = "dm_4k_wb", .enable = 1, .cfg = CACHE_DIRECT_MAPPED | CACHE_SIZE_4K | CACHE_WRITE_BACK },
+    { .name = "4way_4k_wb", .enable = 1, .cfg = CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK },
+    { .name = "4way_8k_wb", .enable = 1, .cfg = CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK },
+};
+
+#define CONFIG_COUNT (sizeof(configs) / sizeof(configs[0]))
+
+static void configure(unsigned c) {
+    dcache_flush();
+    dcache_enable(0);
+    if (configs[c].enable) {
+        dcache_write_cfg(configs[c].cfg);
+        dcache_enable(1);
+    }
+}
+
+int main() {
+    // initializes the UART, performance counters, peripherals etc.
+    platform_init();
+    perf_init();
+
+    icache_write_cfg(CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO);
+    icache_enable(1);
+
+    printf("workload,config,memdist,cycles,stall_cycles,bus_idle,dcache_miss,checksum\n");
+
+    for (unsigned w = 0; w < workload_count; w++) {
+        const struct workload* workload = &workloads[w];
+        uint64_t cycles[CONFIG_COUNT][MEMDIST_COUNT];
+
+        perf_memdist_set(0);
+        workload->init();
+
+        for (unsigned c = 0; c < CONFIG_COUNT; c++) {
+            for (unsigned m = 0; m < MEMDIST_COUNT; m++) {
+                struct perf_session session;
+                uint32_t checksum = 0;
+
+                perf_session_init(&session);
+                perf_session_add(&session, "stall_cycles");
+                perf_session_add(&session, "bus_idle");
+                perf_session_add(&session, "dcache_miss");
+
+                configure(c);
+                perf_memdist_set(memdists[m]);
+
+                PERF_SESSION_RUN(&session) {
+                    checksum = workload->run();
+                }
+
+                perf_memdist_set(0);
+
+                cycles[c][m] = perf_session_cycles(&session);
+                printf("%s,%s,%u,%llu,%llu,%llu,%llu,%u\n",
+                       workload->name, configs[c].name, memdists[m], cycles[c][m],
+                       perf_session_get(&session, "stall_cycles"),
+                       perf_session_get(&session, "bus_idle"),
+                       perf_session_get(&session, "dcache_miss"), checksum);
+            }
+        }
+
+        /*
+         * Latency sensitivity: slowdown at the largest distance with respect
+         * to distance 0. The best config is the fastest at the largest distance.
+         */
+        unsigned best = 0;
+        for (unsigned c = 0; c < CONFIG_COUNT; c++) {
+            uint64_t slowdown = cycles[c][MEMDIST_COUNT - 1] * 1000 / cycles[c][0];
+            printf("# %s,%s: slowdown x%llu.%03llu from memdist %u to %u\n",
+                   workload->name, configs[c].name, slowdown / 1000, slowdown % 1000,
+                   memdists[0], memdists[MEMDIST_COUNT - 1]);
+
+            if (cycles[c][MEMDIST_COUNT - 1] < cycles[best][MEMDIST_COUNT - 1])
+                best = c;
+        }
+        printf("# %s: best config at memdist %u is %s\n",
+               workload->name, memdists[MEMDIST_COUNT - 1], configs[best].name);
+    }
+
+    configure(0);
+
+    return 0;
+}
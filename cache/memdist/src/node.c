@@ -0,0 +1 @@
+../../tasks/src/node.c
\ No newline at end of file
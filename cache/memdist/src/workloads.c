@@ -0,0 +1,106 @@
+#include <defs.h>
+#include <fractal_fxpt.h>
+#include <node.h>
+
+#include <workloads.h>
+
+#pragma region "Fractal"
+
+#define FRACTAL_WIDTH 128
+#define FRACTAL_HEIGHT 128
+#define FRACTAL_N_MAX 64
+
+static rgb565 frame_buffer[FRACTAL_WIDTH * FRACTAL_HEIGHT];
+
+static void fractal_init() {
+}
+
+static uint32_t fractal_run() {
+    const fxpt_4_28 frac_width = 0x30000000; // 3.0
+    const fxpt_4_28 cx_0 = 0xe0000000;       // -2.0
+    const fxpt_4_28 cy_0 = 0xe8000000;       // -1.5
+
+    // the loop through the function pointers, so that the profiled footprint does not
+    // depend on the specialized renderers of draw_fractal
+    draw_fractal_indirect(frame_buffer, FRACTAL_WIDTH, FRACTAL_HEIGHT,
+                          &calc_mandelbrot_point_soft, &iter_to_colour,
+                          cx_0, cy_0, frac_width / FRACTAL_WIDTH, FRACTAL_N_MAX);
+
+    uint32_t checksum = 0;
+    for (int i = 0; i < FRACTAL_WIDTH * FRACTAL_HEIGHT; i++)
+        checksum += frame_buffer[i];
+    return checksum;
+}
+
+#pragma endregion
+
+#pragma region "Matrix-vector"
+
+/* same layout as cache/tasks/src/task3.c */
+#define MATRIX_N 256
+
+typedef int32_t elem_t;
+
+static elem_t (*matrix)[MATRIX_N];
+
+static elem_t in_vector[MATRIX_N];
+
+static elem_t out_vector[MATRIX_N];
+
+static void matvec_init() {
+    // the matrix is huge, place it outside of the executable
+    matrix = (elem_t(*)[MATRIX_N])0x01000000;
+
+    for (int i = 0; i < MATRIX_N; ++i)
+        for (int j = 0; j < MATRIX_N; ++j)
+            matrix[i][j] = (i == j);
+
+    for (int i = 0; i < MATRIX_N; ++i)
+        in_vector[i] = i;
+}
+
+static uint32_t matvec_run() {
+    uint32_t checksum = 0;
+
+    for (int i = 0; i < MATRIX_N; ++i) {
+        elem_t partial_result = 0;
+        for (int j = 0; j < MATRIX_N; ++j)
+            partial_result += matrix[i][j] * in_vector[j];
+        out_vector[i] = partial_result;
+        checksum += partial_result;
+    }
+
+    return checksum;
+}
+
+#pragma endregion
+
+#pragma region "Linked-list walk"
+
+#define LOG2NUM_NODES 10
+
+static node_t nodes[1 << LOG2NUM_NODES] __aligned(sizeof(node_t));
+
+static void list_init() {
+    nodes_init(nodes, LOG2NUM_NODES);
+}
+
+/* `node_count` without the printing */
+static uint32_t list_run() {
+    uint32_t result = 0;
+
+    for (node_t* node = &nodes[0]; node; node = node->next)
+        result += node->id;
+
+    return result;
+}
+
+#pragma endregion
+
+const struct workload workloads[] = {
+    { .name = "fractal", .init = &fractal_init, .run = &fractal_run },
+    { .name = "matvec", .init = &matvec_init, .run = &matvec_run },
+    { .name = "list_walk", .init = &list_init, .run = &list_run },
+};
+
+const unsigned workload_count = sizeof(workloads) / sizeof(workloads[0]);
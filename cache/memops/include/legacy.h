@@ -0,0 +1,20 @@
+#ifndef LEGACY_H_INCLUDED
+#define LEGACY_H_INCLUDED
+
+#include <stddef.h>
+
+/**
+ * @brief The former `memcpy` of support/src/string.c, as the baseline:
+ * byte copies through a volatile pointer, word copies when both
+ * operands have the same alignment.
+ *
+ */
+void* legacy_memcpy(void* dst0, const void* src0, size_t length);
+
+/**
+ * @brief The former `memset` of support/src/string.c: one byte per iteration.
+ *
+ */
+void* legacy_memset(void* dest, int val, size_t len);
+
+#endif /* LEGACY_H_INCLUDED */
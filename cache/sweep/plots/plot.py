@@ -1,11 +1,13 @@
 import matplotlib
 import matplotlib.pyplot as plt
-import re
 import pathlib
 import dataclasses
+import sys
 from typing import *
 
-REGEX = r"^.*?(\d+).*?(\d+).*?(True|False).*?(\d+).*?(\d+)$"
+sys.path.append(str(pathlib.Path(__file__).resolve().parent.parent / "support" / "tools"))
+import perfdb
+
 COUNT = 256
 
 
@@ -21,17 +23,17 @@ class Row:
 def load_data(fpath: pathlib.Path) -> List[Row]:
     l: List[Row] = []
 
-    with open(fpath) as f:
-        matches = re.finditer(REGEX, f.read(), re.MULTILINE)
-        for match in matches:
-            groups = match.groups()
-            l.append(Row(
-                count=int(groups[0]),
-                datalen=int(groups[1]),
-                packed=groups[2] == "True",
-                sizeof=int(groups[3]),
-                misses=int(groups[4])
-            ))
+    for record in perfdb.load_capture(fpath):
+        if record.name != "items_find":
+            continue
+        params = record.params()
+        l.append(Row(
+            count=int(params["count"]),
+            datalen=int(params["datalen"]),
+            packed=params["packed"] == "1",
+            sizeof=record.values["sizeof_item"],
+            misses=record.values["dcache_miss"]
+        ))
 
     return l
 
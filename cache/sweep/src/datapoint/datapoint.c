@@ -1,5 +1,6 @@
 #include <defs.h>
 #include <perf.h>
+#include <perf_export.h>
 #include <cache.h>
 #include <stdio.h>
 #include <string.h>
@@ -59,11 +60,17 @@ void PARAM_ENTRY() {
     items_find(PARAM_MAGIC);
     perf_stop();
 
-    printf(
-        "Config: %-32s, sizeof(item_t): %2d, sizeof(items): %2d, dcache misses: %10lld\n",
-        PARAM_DESC,
-        sizeof(item_t),
-        sizeof(items),
-        perf_read_counter(PERF_COUNTER_0)
-    );
+#ifdef PARAM_PACKED
+    const int packed = 1;
+#else
+    const int packed = 0;
+#endif
+    char config[48];
+    snprintf(config, sizeof(config), "count=%d,datalen=%d,packed=%d", PARAM_COUNT, PARAM_DATALEN, packed);
+
+    perf_export_begin("items_find", config);
+    perf_export_value("sizeof_item", sizeof(item_t));
+    perf_export_value("sizeof_items", sizeof(items));
+    perf_export_value("dcache_miss", perf_read_counter(PERF_COUNTER_0));
+    perf_export_end();
 }
@@ -1,6 +1,7 @@
 #include "datapoint/entry.h"
 #include <cache.h>
 #include <perf.h>
+#include <perf_export.h>
 #include <platform.h>
 #include <stdio.h>
 #include <string.h>
@@ -14,6 +15,7 @@ int main() {
     dcache_enable(1);
 
     perf_set_mask(PERF_COUNTER_0, PERF_DCACHE_MISS_MASK);
+    perf_export_init(PERF_EXPORT_CSV, 0);
 
     entry();
 
@@ -3,4 +3,7 @@
 
 void task1_main();
 
+/// @brief Prints the layout of node_t, also used to measure the output cost.
+void task1_print_layout();
+
 #endif /* TASK1_H_INCLUDED */
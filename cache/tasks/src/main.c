@@ -13,17 +13,18 @@
 int main() {
     // initializes the UART, performance counters, peripherals etc.
     platform_init();
+    stdout_set_mode(STDOUT_LINE_BUFFERED);
     perf_init();
 
     dcache_write_cfg(CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK);
     dcache_enable(1);
 
-    perf_set_mask(PERF_COUNTER_0, PERF_DCACHE_MISS_MASK);
-
     task1_main();
     task2_main();
     task3_main();
     task4_main();
 
+    stdout_benchmark("task1_layout", &task1_print_layout);
+
     return 0;
 }
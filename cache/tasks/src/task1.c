@@ -1,7 +1,7 @@
 #include <cache.h>
 #include <defs.h>
 #include <node.h>
-#include <perf.h>
+#include <perf_session.h>
 #include <stdio.h>
 #include <task1.h>
 
@@ -10,7 +10,7 @@ static node_t nodes[1 << LOG2NUM_NODES]
     // what does __aligned(X) do? (defined in defs.h)
     __aligned(sizeof(node_t));
 
-static void print_layout() {
+void task1_print_layout() {
     node_t node;
 
     uint32_t addr0 = (uint32_t)&node;
@@ -30,18 +30,22 @@ static void print_layout() {
 
 void task1_main() {
     puts(__func__);
-    print_layout();
+    task1_print_layout();
 
     nodes_init(nodes, LOG2NUM_NODES);
 
+    struct perf_session session;
+    perf_session_init(&session);
+    perf_session_add(&session, "dcache_miss");
+
     dcache_flush();
 
-    perf_start();
+    perf_session_begin(&session);
     node_count(&nodes[0]);
-    perf_stop();
+    perf_session_end(&session);
 
     printf(
         "Task 1: dcache misses: %10lld\n",
-        perf_read_counter(PERF_COUNTER_0)
+        perf_session_get(&session, "dcache_miss")
     );
 }
@@ -1,7 +1,7 @@
 #include <cache.h>
 #include <defs.h>
 #include <item.h>
-#include <perf.h>
+#include <perf_session.h>
 #include <stdio.h>
 #include <task2.h>
 
@@ -13,16 +13,20 @@ void task2_main() {
     
     items_init(items, LOG2NUM_ITEMS);
 
+    struct perf_session session;
+    perf_session_init(&session);
+    perf_session_add(&session, "dcache_miss");
+
     dcache_flush();
 
-    perf_start();
+    perf_session_begin(&session);
     item_t* item = items_find(items, LOG2NUM_ITEMS, 15);
-    perf_stop();
+    perf_session_end(&session);
 
     printf("Item ID = %u, data = %s\n", item->id, item->data);
 
     printf(
         "Task 2: dcache misses: %10lld\n",
-        perf_read_counter(PERF_COUNTER_0)
+        perf_session_get(&session, "dcache_miss")
     );
 }
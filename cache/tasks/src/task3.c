@@ -1,6 +1,6 @@
 #include <cache.h>
 #include <defs.h>
-#include <perf.h>
+#include <perf_session.h>
 #include <stdio.h>
 #include <task3.h>
 
@@ -90,15 +90,19 @@ void task3_main() {
 
     init();
 
+    struct perf_session session;
+    perf_session_init(&session);
+    perf_session_add(&session, "dcache_miss");
+
     dcache_flush();
 
-    perf_start();
+    perf_session_begin(&session);
     multiply();
-    perf_stop();
+    perf_session_end(&session);
 
     printf(
         "Task 3: dcache misses: %10lld\n",
-        perf_read_counter(PERF_COUNTER_0)
+        perf_session_get(&session, "dcache_miss")
     );
 
     verify();
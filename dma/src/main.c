@@ -2,30 +2,173 @@
 #include <stddef.h>
 #include <cache.h>
 #include <perf.h>
+#include <perf_session.h>
 #include <vga.h>
 #include <swap.h>
 #include <defs.h>
 #include <dma.h>
+#include <dma_copy.h>
 #include <string.h>
 #include "fractal_fxpt.h"
 #include <main.h>
 
 #define __REALLY_FAST__
-#define SPM_BASE_ADDRESS 0XC0000000
-#define BURST_SIZE 0x000000ff;
+#define SPM_BASE_ADDRESS DMA_SPM_ADDRESS
+#define BURST_SIZE 0x000000ff
+
+//! Number of row buffers in the SPM: the kernel fills one while the DMA drains the others.
+//! 1 is the serial version, where computing and transferring never overlap.
+#define SPM_ROW_BUFFERS 2
+
+//! Size of a row in the SPM, in bytes
+#define SPM_ROW_BYTES (SCREEN_WIDTH * sizeof(rgb565))
+
+//! Largest number of rows per transfer: the row buffers fill the SPM data region,
+//! the end of the SPM holds the stacks
+#define MAX_BATCH_ROWS (DMA_SPM_DATA_SIZE / (SPM_ROW_BUFFERS * SPM_ROW_BYTES))
+
+//! Transfers timed per calibration point
+#define CALIBRATION_RUNS 4
+
+//! Burst size fields tried by the calibration
+static const uint32_t calibration_bursts[] = { 0x0F, 0x1F, 0x3F, 0x7F, 0xFF };
+
+#define CALIBRATION_BURSTS (sizeof(calibration_bursts) / sizeof(calibration_bursts[0]))
+
+//! Transfer parameters of the renderer
+struct dma_config {
+   int buffers;      //!< number of SPM buffers, 1 for the serial version
+   int rows;         //!< rows per transfer, a power of 2 up to MAX_BATCH_ROWS
+   uint32_t burst;   //!< burst size field
+};
 
 rgb565 frameBuffer[SCREEN_WIDTH*SCREEN_HEIGHT];
 
+static void session_init(struct perf_session *session) {
+   perf_session_init(session);
+   perf_session_add(session, "stall_cycles");
+   perf_session_add(session, "icache_nop_insertion");
+   perf_session_add(session, "bus_idle");
+   perf_session_add(session, "icache_miss");
+   perf_session_add(session, "dcache_miss");
+}
+
+//! \brief Measures the SPM to memory bandwidth for each burst size and number of rows.
+//!
+//! Prints the curve as CSV and returns the fastest configuration, with SPM_ROW_BUFFERS buffers.
+static struct dma_config calibrate_dma() {
+   struct dma_config best = { SPM_ROW_BUFFERS, 1, BURST_SIZE };
+   uint64_t best_bandwidth = 0;
+   struct dma_desc desc;
+
+   printf("dma_bandwidth,burst,rows,bytes,cycles,bytes_per_kcycle\n");
+   for (unsigned b = 0 ; b < CALIBRATION_BURSTS ; b++) {
+      for (int rows = 1 ; rows <= MAX_BATCH_ROWS ; rows <<= 1) {
+         uint32_t bytes = rows * SPM_ROW_BYTES;
+         dma_desc_init(&desc, frameBuffer, SPM_BASE_ADDRESS, bytes / 4, DMA_FROM_SPM_TO_MEM);
+         desc.burst = calibration_bursts[b];
+
+         perf_start();
+         perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+         for (int r = 0 ; r < CALIBRATION_RUNS ; r++) {
+            dma_submit(&desc);
+            dma_wait(&desc);
+         }
+         perf_cycles_t cycles = (perf_read_counter(PERF_COUNTER_RUNTIME) - start) / CALIBRATION_RUNS;
+         perf_stop();
+
+         uint64_t bandwidth = cycles ? (uint64_t)bytes * 1000 / cycles : 0;
+         printf("dma_bandwidth,0x%02X,%d,%u,%llu,%llu\n", calibration_bursts[b], rows, bytes,
+                (uint64_t)cycles, bandwidth);
+
+         if (!desc.errors && bandwidth > best_bandwidth) {
+            best_bandwidth = bandwidth;
+            best.rows = rows;
+            best.burst = calibration_bursts[b];
+         }
+      }
+   }
+
+   printf("# selected burst 0x%02X, %d rows per transfer\n", best.burst, best.rows);
+   return best;
+}
+
+//! \brief Draws the fractal with the custom instruction, through the SPM.
+//!
+//! The rows are computed in batches of config.rows into SPM buffer (batch % buffers), then
+//! the batch is transferred at once. Before reusing a buffer, the CPU waits for the
+//! transfer of the batch it last held.
+static void draw_fractal_dma(fxpt_4_28 delta, struct dma_config config) {
+   struct dma_desc desc[SPM_ROW_BUFFERS];
+   int color = (2<<16) | N_MAX;
+   asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(color),[in2]"r"(delta));
+
+   for (int b = 0 ; b < config.buffers ; b++) {
+      dma_desc_init(&desc[b], NULL, SPM_BASE_ADDRESS + b * config.rows * SPM_ROW_BYTES,
+                    config.rows * SCREEN_WIDTH / 2, DMA_FROM_SPM_TO_MEM);
+      desc[b].burst = config.burst;
+   }
+
+   fxpt_4_28 cy = CY_0;
+   for (int k = 0 ; k < SCREEN_HEIGHT ; k += config.rows) {
+      struct dma_desc *batch = &desc[(k / config.rows) % config.buffers];
+
+      /* the buffer is free once the transfer of its former batch is done */
+      dma_wait(batch);
+
+      volatile uint32_t* spm_buffer = (volatile uint32_t*) batch->spm;
+
+      for (int j = 0 ; j < config.rows ; j++) {
+         fxpt_4_28 cx = CX_0;
+         for (int i = 0 ; i < SCREEN_WIDTH ; i+=2) {
+            asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
+            *(spm_buffer++) = color;
+            cx += delta << 1;
+         }
+         cy += delta;
+      }
+
+      batch->mem = frameBuffer + k * SCREEN_WIDTH;
+      dma_submit(batch);
+   }
+
+   dma_wait(NULL);
+}
+
+//! \brief Prints the cycles per pixel of a frame drawn through the function pointers
+//!        (draw_fractal_indirect) and by the specialized renderer of draw_fractal
+static void print_cycles_per_pixel(const char *kernel, rgb565 *fbuf, calc_frac_point_p cfp_p,
+                                   fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta) {
+   const uint64_t pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+   perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_indirect(fbuf,SCREEN_WIDTH,SCREEN_HEIGHT,cfp_p,&iter_to_colour,cx_0,cy_0,delta,N_MAX);
+   perf_cycles_t indirect = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+   start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(fbuf,SCREEN_WIDTH,SCREEN_HEIGHT,cfp_p,&iter_to_colour,cx_0,cy_0,delta,N_MAX);
+   perf_cycles_t specialized = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+   printf("cycles_per_pixel,%s,%llu.%02llu,%llu.%02llu\n", kernel,
+          indirect / pixels, indirect * 100 / pixels % 100,
+          specialized / pixels, specialized * 100 / pixels % 100);
+}
+
+//! \brief Prints a CSV line of the renderer comparison.
+static void print_run(const struct perf_session *session, struct dma_config config) {
+   printf("pipeline,%d,%d,0x%02X,%llu,%llu\n", config.buffers, config.rows, config.burst,
+          perf_session_cycles(session), perf_session_get(session, "bus_idle"));
+}
+
 int main() {
    volatile unsigned int *vga = (unsigned int *) 0X50000020;
    volatile unsigned int reg, hi;
    uint32_t *pixel;
 
+   struct perf_session session;
+
    perf_init();
-   perf_set_mask(PERF_COUNTER_0, PERF_ICACHE_NOP_INSERTION_MASK | PERF_STALL_CYCLES_MASK);
-   perf_set_mask(PERF_COUNTER_1, PERF_BUS_IDLE_MASK);
-   perf_set_mask(PERF_COUNTER_2, PERF_ICACHE_MISS_MASK);
-   perf_set_mask(PERF_COUNTER_3, PERF_DCACHE_MISS_MASK);
+   session_init(&session);
 
    vga_clear();
    printf("Starting drawing a fractal\n");
@@ -43,7 +186,7 @@ int main() {
    vga[3] = swap_u32( (unsigned int) &frameBuffer[0] );
    
    /* Clear screen */
-   //for (int i = 0 ; i < SCREEN_WIDTH*SCREEN_HEIGHT ; i++) frameBuffer[i]=0;
+   dma_memset(frameBuffer, 0, sizeof(frameBuffer));
 
    #if 0
    // Define buffer in SPM region, initialize to 0
@@ -53,79 +196,95 @@ int main() {
    }
    printf("SPM Fuffer = %x ... %x \n", spm_buffer[0], spm_buffer[SCREEN_WIDTH / 2 - 1]);
 
-   volatile uint32_t* DMA_BASE = (volatile uint32_t*) DMA_BASE_ADDRESS;
-  
-   // Specify location of frame buffer in RAM to DMA
-   *(DMA_BASE + MEMORY_ADDRESS_ID) = swap_u32((unsigned int) &frameBuffer[0]);
-   printf("DMA - FB address: %x, expecting %x \n", swap_u32(*(DMA_BASE + MEMORY_ADDRESS_ID)), frameBuffer);
-
-   // Specify location of SPM buffer to DMA
-   *(DMA_BASE + SPM_ADDRESS_ID) = swap_u32((unsigned int) SPM_BASE_ADDRESS);
-   printf("DMA - SPM Address: %x, expecting %x \n", swap_u32(*(DMA_BASE + SPM_ADDRESS_ID)), SPM_BASE_ADDRESS);
-   
-   // Size of the buffer to transfer (in 32-bit words)
-   *(DMA_BASE + TRANSFER_SIZE_ID) = swap_u32(SCREEN_WIDTH / 2);
-   printf("DMA - Transfer size: %d, expecting %d \n", swap_u32(*(DMA_BASE + TRANSFER_SIZE_ID)), SCREEN_WIDTH / 2);
-   
-   // Start DMA transfer + give
-   uint32_t burst_size = BURST_SIZE;
-   *(DMA_BASE + START_STATUS_ID) = swap_u32(DMA_FROM_SPM_TO_MEM | burst_size);
-   printf("Value of Status Register: %x \n", swap_u32(*(DMA_BASE + START_STATUS_ID)));
+   // Transfer the SPM buffer to the frame buffer (size in 32-bit words)
+   struct dma_desc desc;
+   dma_desc_init(&desc, frameBuffer, SPM_BASE_ADDRESS, SCREEN_WIDTH / 2, DMA_FROM_SPM_TO_MEM);
+   desc.burst = BURST_SIZE;
+   dma_submit(&desc);
 
    // Wait until DMA is done transferring data
-   uint32_t busy_bit = DMA_BUSY_BIT;
-   while(  swap_u32(*(DMA_BASE + START_STATUS_ID)) & busy_bit  ) {
-      printf("DMA busy..\n");
-   }
+   uint32_t errors = dma_wait(&desc);
+   printf("DMA - errors: %x (%s) \n", errors, dma_error_string(errors));
 
    printf("MEM Buffer = %x ... %x \n", frameBuffer[0], frameBuffer[SCREEN_WIDTH]);
    #endif
 
-   perf_start();
-
-
 #ifdef __REALLY_FAST__
+   struct dma_config serial = { 1, 1, BURST_SIZE };
+   struct dma_config pipelined = { SPM_ROW_BUFFERS, 1, BURST_SIZE };
+   struct dma_config tuned = calibrate_dma();
+   struct perf_session serial_session, pipelined_session;
+   session_init(&serial_session);
+   session_init(&pipelined_session);
 
-   uint32_t burst_size = BURST_SIZE;
-   uint32_t busy_bit = DMA_BUSY_BIT;
-   int color = (2<<16) | N_MAX;
-   asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(color),[in2]"r"(delta));
-   fxpt_4_28 cy = CY_0;
-   for (int k = 0 ; k < SCREEN_HEIGHT ; k++) {
-      fxpt_4_28 cx = CX_0;
+   PERF_SESSION_RUN(&serial_session) {
+      draw_fractal_dma(delta, serial);
+   }
 
-      volatile uint32_t* spm_buffer = (volatile uint32_t*) SPM_BASE_ADDRESS;
-      volatile uint32_t* DMA_BASE = (volatile uint32_t*) DMA_BASE_ADDRESS;
+   PERF_SESSION_RUN(&pipelined_session) {
+      draw_fractal_dma(delta, pipelined);
+   }
 
-      for (int i = 0 ; i < SCREEN_WIDTH ; i+=2) {
-         asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
-         *(spm_buffer++) = color;
-         cx += delta << 1;
-      }
+   PERF_SESSION_RUN(&session) {
+      draw_fractal_dma(delta, tuned);
+   }
 
-      *(DMA_BASE + MEMORY_ADDRESS_ID) = swap_u32((unsigned int) (frameBuffer + k * SCREEN_WIDTH)); // memory loc
-      *(DMA_BASE + SPM_ADDRESS_ID) = swap_u32((unsigned int) SPM_BASE_ADDRESS); // spm loc
-      *(DMA_BASE + TRANSFER_SIZE_ID) = swap_u32(SCREEN_WIDTH / 2); // size of buffer
-      *(DMA_BASE + START_STATUS_ID) = swap_u32(DMA_FROM_SPM_TO_MEM | burst_size); // start transfer
+   printf("Done\n");
+   perf_session_print(&serial_session, "Fractal, serial");
+   perf_session_print(&pipelined_session, "Fractal, " STRINGIZE(SPM_ROW_BUFFERS) " SPM buffers");
+   perf_session_print(&session, "Fractal, calibrated batches");
 
-      while(  swap_u32(*(DMA_BASE + START_STATUS_ID)) & busy_bit  ) {
-         printf("DMA busy..\n");
-      }
+   printf("pipeline,buffers,rows,burst,cycles,bus_idle\n");
+   print_run(&serial_session, serial);
+   print_run(&pipelined_session, pipelined);
+   print_run(&session, tuned);
 
-      cy += delta;
-   }
+   uint64_t serial_cycles = perf_session_cycles(&serial_session), cycles = perf_session_cycles(&session);
+   printf("# speedup x%llu.%02llu\n", serial_cycles / cycles, serial_cycles * 100 / cycles % 100);
 #else
+   perf_session_begin(&session);
    draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
-#endif
 
    dcache_flush();
    asm volatile ("l.lwz %[out1],0(%[in1])":[out1]"=r"(pixel):[in1]"r"(frameBuffer)); // dummy instruction to wait for the flush to be finished
-   perf_stop();
+   perf_session_end(&session);
 
    printf("Done\n");
-   perf_print_cycles( PERF_COUNTER_2 , "I$ misses" );
-   perf_print_cycles( PERF_COUNTER_3 , "D$ misses" );
-   perf_print_cycles( PERF_COUNTER_0 , "Stall time" );
-   perf_print_cycles( PERF_COUNTER_1 , "Bus idle time" );
-   perf_print_cycles( PERF_COUNTER_RUNTIME , "Runtime" );
+   perf_session_print(&session, "Fractal");
+#endif
+
+   /* the software kernel, then the same frame skipping the cardioid, the period-2 bulb and the periodic orbits */
+   struct perf_session soft_session, fast_session;
+   session_init(&soft_session);
+   session_init(&fast_session);
+
+   mandelbrot_iterations = 0;
+   perf_session_begin(&soft_session);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+
+   dcache_flush();
+   asm volatile ("l.lwz %[out1],0(%[in1])":[out1]"=r"(pixel):[in1]"r"(frameBuffer));
+   perf_session_end(&soft_session);
+   uint32_t soft_iterations = mandelbrot_iterations;
+
+   mandelbrot_iterations = 0;
+   perf_session_begin(&fast_session);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_fast, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+
+   dcache_flush();
+   asm volatile ("l.lwz %[out1],0(%[in1])":[out1]"=r"(pixel):[in1]"r"(frameBuffer));
+   perf_session_end(&fast_session);
+
+   perf_session_print(&soft_session, "Fractal, software kernel");
+   perf_session_print(&fast_session, "Fractal, interior checks");
+   printf("kernel,iterations,cycles\n");
+   printf("soft,%u,%llu\n", soft_iterations, perf_session_cycles(&soft_session));
+   printf("fast,%u,%llu\n", mandelbrot_iterations, perf_session_cycles(&fast_session));
+
+   /* the software renderers, through the function pointers and specialized */
+   perf_start();
+   printf("cycles_per_pixel,kernel,indirect,specialized\n");
+   print_cycles_per_pixel("soft",frameBuffer,&calc_mandelbrot_point_soft,CX_0,CY_0,delta);
+   print_cycles_per_pixel("fast",frameBuffer,&calc_mandelbrot_point_fast,CX_0,CY_0,delta);
+   perf_stop();
 }
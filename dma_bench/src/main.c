@@ -0,0 +1,290 @@
+#include <cache.h>
+#include <dma.h>
+#include <dma_copy.h>
+#include <perf.h>
+#include <platform.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/// @brief SPM region used by the transfers.
+#define SPM_BENCH_ADDRESS 0xC0000000
+
+/// @brief Largest transfer, in bytes.
+#define MAX_SIZE 4096
+
+/// @brief Largest memory to memory copy, in bytes.
+#define MAX_COPY_SIZE (16 << 10)
+
+/// @brief Runs per measurement, averaged.
+#define RUNS 4
+
+/// @brief Buffer read by the concurrent CPU traffic, 4 times the largest D$.
+#define TRAFFIC_SIZE (32 << 10)
+
+/// @brief Cache lines read by one unit of CPU traffic.
+#define TRAFFIC_UNIT_LINES 8
+
+/// @brief Counter of the CPU stall cycles.
+#define STALL_COUNTER PERF_COUNTER_0
+
+static uint32_t mem_buffer[MAX_SIZE / 4] __attribute__((aligned(32)));
+static uint8_t copy_src[MAX_COPY_SIZE] __attribute__((aligned(32)));
+static uint8_t copy_dst[MAX_COPY_SIZE] __attribute__((aligned(32)));
+static uint32_t traffic_buffer[TRAFFIC_SIZE / 4] __attribute__((aligned(32)));
+
+static const uint32_t sizes[] = { 4, 16, 64, 256, 1024, MAX_SIZE };
+static const uint32_t copy_sizes[] = { 16, 64, 256, 1024, 4096, MAX_COPY_SIZE };
+static const uint32_t bursts[] = { 0x03, 0x0F, 0x3F, 0xFF };
+
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+#define COPY_SIZE_COUNT (sizeof(copy_sizes) / sizeof(copy_sizes[0]))
+#define BURST_COUNT (sizeof(bursts) / sizeof(bursts[0]))
+
+static const struct {
+    const char* name;
+    uint32_t direction;
+} directions[] = {
+    { "spm_to_mem", DMA_FROM_SPM_TO_MEM },
+    { "mem_to_spm", DMA_FROM_MEM_TO_SPM },
+};
+
+#define DIRECTION_COUNT (sizeof(directions) / sizeof(directions[0]))
+
+static const struct {
+    const char* name;
+    int enable;
+    uint32_t cfg;
+} dcache_configs[] = {
+    { "off", 0, 0 },
+    { "dm_8k_wb", 1, CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_WRITE_BACK },
+    { "4way_8k_wb", 1, CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK },
+    { "4way_8k_wt", 1, CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_THROUGH },
+};
+
+#define DCACHE_COUNT (sizeof(dcache_configs) / sizeof(dcache_configs[0]))
+
+/**
+ * @brief Averages of one measured point.
+ *
+ */
+struct point {
+    /** @brief Cycles spent in `dma_submit`, i.e. programming the registers. */
+    uint64_t submit;
+
+    /** @brief Cycles from the submission to the completion. */
+    uint64_t cycles;
+
+    /** @brief Units of CPU traffic run during the transfer. */
+    uint64_t units;
+
+    /** @brief CPU stall cycles during the transfer. */
+    uint64_t stalls;
+};
+
+static volatile uint32_t traffic_sink;
+static uint32_t traffic_index;
+
+static uint64_t now() {
+    return perf_read_counter(PERF_COUNTER_RUNTIME);
+}
+
+/**
+ * @brief Reads `TRAFFIC_UNIT_LINES` cache lines of the traffic buffer, which miss in the D$.
+ *
+ */
+static void traffic_unit() {
+    uint32_t sum = 0;
+    for (int i = 0; i < TRAFFIC_UNIT_LINES; i++) {
+        sum += traffic_buffer[traffic_index];
+        traffic_index = (traffic_index + 8) % (TRAFFIC_SIZE / 4);
+    }
+    traffic_sink = sum;
+}
+
+/**
+ * @brief Stall cycles of `units` units of traffic without transfer.
+ *
+ */
+static uint64_t traffic_stalls(uint64_t units) {
+    uint64_t start = perf_read_counter(STALL_COUNTER);
+    for (uint64_t u = 0; u < units; u++)
+        traffic_unit();
+    return perf_read_counter(STALL_COUNTER) - start;
+}
+
+static struct point measure_dma(uint32_t direction, uint32_t burst, uint32_t bytes, int traffic) {
+    struct point point = { 0, 0, 0, 0 };
+    struct dma_desc desc;
+
+    for (int r = 0; r <= RUNS; r++) {
+        dma_desc_init(&desc, mem_buffer, SPM_BENCH_ADDRESS, bytes / 4, direction);
+        desc.burst = burst;
+
+        uint64_t stalls = perf_read_counter(STALL_COUNTER);
+        uint64_t start = now();
+        dma_submit(&desc);
+        uint64_t submitted = now();
+
+        uint64_t units = 0;
+        if (traffic) {
+            while (!dma_poll(&desc)) {
+                traffic_unit();
+                units++;
+            }
+        } else {
+            dma_wait(&desc);
+        }
+
+        uint64_t end = now();
+
+        /* the first run warms the caches */
+        if (r) {
+            point.submit += submitted - start;
+            point.cycles += end - start;
+            point.units += units;
+            point.stalls += perf_read_counter(STALL_COUNTER) - stalls;
+        }
+    }
+
+    if (desc.errors)
+        printf("# transfer error: %s\n", dma_error_string(desc.errors));
+
+    point.submit /= RUNS;
+    point.cycles /= RUNS;
+    point.units /= RUNS;
+    point.stalls /= RUNS;
+    return point;
+}
+
+static uint64_t measure_memcpy(void* dst, const void* src, uint32_t bytes, void* (*copy)(void*, const void*, size_t)) {
+    uint64_t cycles = 0;
+
+    for (int r = 0; r <= RUNS; r++) {
+        uint64_t start = now();
+        copy(dst, src, bytes);
+        if (r)
+            cycles += now() - start;
+    }
+
+    return cycles / RUNS;
+}
+
+static uint64_t bytes_per_kcycle(uint32_t bytes, uint64_t cycles) {
+    return cycles ? (uint64_t)bytes * 1000 / cycles : 0;
+}
+
+int main() {
+    // initializes the UART, performance counters, peripherals etc.
+    platform_init();
+    perf_init();
+
+    icache_write_cfg(CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO);
+    icache_enable(1);
+
+    perf_set_mask(STALL_COUNTER, PERF_STALL_CYCLES_MASK);
+    perf_start();
+
+    void* spm = (void*)SPM_BENCH_ADDRESS;
+
+    /* fastest transfer without traffic, per size */
+    static uint64_t best[DCACHE_COUNT][DIRECTION_COUNT][SIZE_COUNT];
+    static uint64_t cpu[DCACHE_COUNT][DIRECTION_COUNT][SIZE_COUNT];
+
+    /* memory to memory copies, memcpy and dma_memcpy, per size */
+    static uint64_t copy_cpu[DCACHE_COUNT][COPY_SIZE_COUNT];
+    static uint64_t copy_dma[DCACHE_COUNT][COPY_SIZE_COUNT];
+
+    printf("dma,direction,dcache,burst,bytes,traffic,submit_cycles,cycles,bytes_per_kcycle,"
+           "cpu_units,cpu_stalls,baseline_stalls\n");
+
+    for (unsigned c = 0; c < DCACHE_COUNT; c++) {
+        dcache_enable(0);
+        dcache_write_cfg(dcache_configs[c].cfg);
+        dcache_enable(dcache_configs[c].enable);
+
+        for (unsigned d = 0; d < DIRECTION_COUNT; d++) {
+            for (unsigned b = 0; b < BURST_COUNT; b++) {
+                for (unsigned s = 0; s < SIZE_COUNT; s++) {
+                    for (int traffic = 0; traffic <= 1; traffic++) {
+                        struct point p = measure_dma(directions[d].direction, bursts[b], sizes[s], traffic);
+                        uint64_t baseline = traffic ? traffic_stalls(p.units) : 0;
+
+                        if (!traffic && (!best[c][d][s] || p.cycles < best[c][d][s]))
+                            best[c][d][s] = p.cycles;
+
+                        printf("dma,%s,%s,0x%02X,%u,%d,%llu,%llu,%llu,%llu,%llu,%llu\n", directions[d].name,
+                               dcache_configs[c].name, bursts[b], sizes[s], traffic, p.submit, p.cycles,
+                               bytes_per_kcycle(sizes[s], p.cycles), p.units, p.stalls, baseline);
+                    }
+                }
+            }
+
+            /* the CPU equivalent of the transfer */
+            for (unsigned s = 0; s < SIZE_COUNT; s++) {
+                if (directions[d].direction == DMA_FROM_SPM_TO_MEM)
+                    cpu[c][d][s] = measure_memcpy(mem_buffer, spm, sizes[s], &memcpy);
+                else
+                    cpu[c][d][s] = measure_memcpy(spm, mem_buffer, sizes[s], &memcpy);
+            }
+        }
+    }
+
+    printf("memcpy,direction,dcache,bytes,memcpy_cycles,dma_cycles,memcpy_bytes_per_kcycle,dma_bytes_per_kcycle\n");
+
+    for (unsigned c = 0; c < DCACHE_COUNT; c++) {
+        for (unsigned d = 0; d < DIRECTION_COUNT; d++) {
+            for (unsigned s = 0; s < SIZE_COUNT; s++) {
+                printf("memcpy,%s,%s,%u,%llu,%llu,%llu,%llu\n", directions[d].name, dcache_configs[c].name,
+                       sizes[s], cpu[c][d][s], best[c][d][s], bytes_per_kcycle(sizes[s], cpu[c][d][s]),
+                       bytes_per_kcycle(sizes[s], best[c][d][s]));
+            }
+        }
+    }
+
+    /* memory to memory: dma_memcpy (through the SPM, cache maintenance included) against memcpy */
+    for (unsigned c = 0; c < DCACHE_COUNT; c++) {
+        dcache_enable(0);
+        dcache_write_cfg(dcache_configs[c].cfg);
+        dcache_enable(dcache_configs[c].enable);
+
+        for (unsigned s = 0; s < COPY_SIZE_COUNT; s++) {
+            uint64_t cpu_cycles = measure_memcpy(copy_dst, copy_src, copy_sizes[s], &memcpy);
+            uint64_t dma_cycles = measure_memcpy(copy_dst, copy_src, copy_sizes[s], &dma_memcpy);
+            copy_cpu[c][s] = cpu_cycles;
+            copy_dma[c][s] = dma_cycles;
+
+            printf("memcpy,mem_to_mem,%s,%u,%llu,%llu,%llu,%llu\n", dcache_configs[c].name, copy_sizes[s],
+                   cpu_cycles, dma_cycles, bytes_per_kcycle(copy_sizes[s], cpu_cycles),
+                   bytes_per_kcycle(copy_sizes[s], dma_cycles));
+        }
+    }
+
+    /* smallest size from which the fastest transfer beats memcpy */
+    for (unsigned c = 0; c < DCACHE_COUNT; c++) {
+        for (unsigned d = 0; d < DIRECTION_COUNT; d++) {
+            unsigned s = 0;
+            while (s < SIZE_COUNT && best[c][d][s] >= cpu[c][d][s])
+                s++;
+
+            if (s < SIZE_COUNT)
+                printf("# crossover %s %s: %u bytes\n", directions[d].name, dcache_configs[c].name, sizes[s]);
+            else
+                printf("# crossover %s %s: none up to %u bytes\n", directions[d].name, dcache_configs[c].name,
+                       MAX_SIZE);
+        }
+
+        unsigned s = 0;
+        while (s < COPY_SIZE_COUNT && copy_dma[c][s] >= copy_cpu[c][s])
+            s++;
+
+        if (s < COPY_SIZE_COUNT)
+            printf("# crossover mem_to_mem %s: %u bytes\n", dcache_configs[c].name, copy_sizes[s]);
+        else
+            printf("# crossover mem_to_mem %s: none up to %u bytes\n", dcache_configs[c].name, MAX_COPY_SIZE);
+    }
+
+    perf_stop();
+    printf("done.\n");
+    return 0;
+}
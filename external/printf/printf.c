@@ -277,6 +277,111 @@ static size_t _ntoa_format(out_fct_type out, char* buffer, size_t idx, size_t ma
 }
 
 
+// division-free unsigned division by 10 (Hacker's Delight, 10-17)
+// the divisions are software-emulated on cores without a divider, 64-bit ones always are
+static inline uint32_t _divu10_u32(uint32_t n, unsigned int* rem)
+{
+  uint32_t q = (n >> 1) + (n >> 2);
+  q += q >> 4;
+  q += q >> 8;
+  q += q >> 16;
+  q >>= 3;
+  uint32_t r = n - ((q << 3) + (q << 1));
+  if (r > 9U) {
+    q++;
+    r -= 10U;
+  }
+  *rem = (unsigned int)r;
+  return q;
+}
+
+
+static inline uint64_t _divu10_u64(uint64_t n, unsigned int* rem)
+{
+  uint64_t q = (n >> 1) + (n >> 2);
+  q += q >> 4;
+  q += q >> 8;
+  q += q >> 16;
+  q += q >> 32;
+  q >>= 3;
+  uint64_t r = n - ((q << 3) + (q << 1));
+  if (r > 9U) {
+    q++;
+    r -= 10U;
+  }
+  *rem = (unsigned int)r;
+  return q;
+}
+
+
+static inline char _digit(unsigned int digit, unsigned int flags)
+{
+  return (char)(digit < 10U ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10U);
+}
+
+
+// internal: writes the digits of value in reverse order, returns the number of digits
+// bases 10 and powers of 2 (all the bases of the specifiers) do not divide
+static size_t _digits_u32(char* buf, uint32_t value, unsigned int base, unsigned int flags)
+{
+  size_t len = 0U;
+  unsigned int digit;
+
+  if (base == 10U) {
+    do {
+      value = _divu10_u32(value, &digit);
+      buf[len++] = (char)('0' + digit);
+    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+  }
+  else if ((base & (base - 1U)) == 0U) {
+    const unsigned int shift = (base == 16U) ? 4U : (base == 8U) ? 3U : 1U;
+    do {
+      buf[len++] = _digit(value & (base - 1U), flags);
+      value >>= shift;
+    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+  }
+  else {
+    do {
+      buf[len++] = _digit(value % base, flags);
+      value /= base;
+    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+  }
+
+  return len;
+}
+
+
+static size_t _digits_u64(char* buf, uint64_t value, unsigned int base, unsigned int flags)
+{
+  size_t len = 0U;
+  unsigned int digit;
+
+  if (base == 10U) {
+    // 64-bit steps only while the value does not fit in 32 bits
+    while ((value >> 32) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
+      value = _divu10_u64(value, &digit);
+      buf[len++] = (char)('0' + digit);
+    }
+    return len + _digits_u32(buf + len, (uint32_t)value, base, flags);
+  }
+  else if ((base & (base - 1U)) == 0U) {
+    const unsigned int shift = (base == 16U) ? 4U : (base == 8U) ? 3U : 1U;
+    do {
+      buf[len++] = _digit((unsigned int)value & (base - 1U), flags);
+      value >>= shift;
+    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+  }
+  else {
+    do {
+      buf[len++] = _digit((unsigned int)(value % base), flags);
+      value /= base;
+    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+  }
+
+  return len;
+}
+
+
 // internal itoa for 'long' type
 static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxlen, unsigned long value, bool negative, unsigned long base, unsigned int prec, unsigned int width, unsigned int flags)
 {
@@ -290,11 +395,8 @@ static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxl
 
   // write if precision != 0 and value is != 0
   if (!(flags & FLAGS_PRECISION) || value) {
-    do {
-      const char digit = (char)(value % base);
-      buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
-      value /= base;
-    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+    len = (sizeof(unsigned long) == sizeof(uint32_t)) ? _digits_u32(buf, (uint32_t)value, (unsigned int)base, flags)
+                                                      : _digits_u64(buf, value, (unsigned int)base, flags);
   }
 
   return _ntoa_format(out, buffer, idx, maxlen, buf, len, negative, (unsigned int)base, prec, width, flags);
@@ -315,11 +417,7 @@ static size_t _ntoa_long_long(out_fct_type out, char* buffer, size_t idx, size_t
 
   // write if precision != 0 and value is != 0
   if (!(flags & FLAGS_PRECISION) || value) {
-    do {
-      const char digit = (char)(value % base);
-      buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
-      value /= base;
-    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+    len = _digits_u64(buf, value, (unsigned int)base, flags);
   }
 
   return _ntoa_format(out, buffer, idx, maxlen, buf, len, negative, (unsigned int)base, prec, width, flags);
@@ -598,6 +696,41 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
       format++;
     }
 
+    // fast path for the most common specifiers, without flags, width, precision nor length
+    // but 'll': %d, %i, %u, %x, %X, %lld, %lli, %llu, %llx and %llX
+    {
+      const bool is_ll = (format[0] == 'l') && (format[1] == 'l');
+      const char specifier = is_ll ? format[2] : format[0];
+      if ((specifier == 'd') || (specifier == 'i') || (specifier == 'u') || (specifier == 'x') || (specifier == 'X')) {
+        const bool is_signed = (specifier == 'd') || (specifier == 'i');
+        const unsigned int base = is_signed || (specifier == 'u') ? 10U : 16U;
+        flags = (specifier == 'X') ? FLAGS_UPPERCASE : 0U;
+        if (is_ll) {
+#if defined(PRINTF_SUPPORT_LONG_LONG)
+          if (is_signed) {
+            const long long value = va_arg(va, long long);
+            idx = _ntoa_long_long(out, buffer, idx, maxlen, (unsigned long long)(value > 0 ? value : 0 - value), value < 0, base, 0U, 0U, flags);
+          }
+          else {
+            idx = _ntoa_long_long(out, buffer, idx, maxlen, va_arg(va, unsigned long long), false, base, 0U, 0U, flags);
+          }
+#endif
+          format += 3U;
+        }
+        else {
+          if (is_signed) {
+            const int value = va_arg(va, int);
+            idx = _ntoa_long(out, buffer, idx, maxlen, (unsigned int)(value > 0 ? value : 0 - value), value < 0, base, 0U, 0U, flags);
+          }
+          else {
+            idx = _ntoa_long(out, buffer, idx, maxlen, va_arg(va, unsigned int), false, base, 0U, 0U, flags);
+          }
+          format++;
+        }
+        continue;
+      }
+    }
+
     // evaluate flags
     flags = 0U;
     do {
@@ -10,6 +10,10 @@ typedef uint16_t rgb565;
 typedef uint16_t (*calc_frac_point_p)(float cx, float cy, uint16_t n_max);
 
 uint16_t calc_mandelbrot_point_soft(float cx, float cy, uint16_t n_max);
+uint16_t calc_mandelbrot_point_fast(float cx, float cy, uint16_t n_max);
+
+//! Iterations performed by the point calculation functions, to compare them
+extern uint32_t mandelbrot_iterations;
 
 //! Pointer to function mapping iteration to colour value
 typedef rgb565 (*iter_to_colour_p)(uint16_t iter, uint16_t n_max);
@@ -18,8 +22,13 @@ rgb565 iter_to_bw(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour(uint16_t iter, uint16_t n_max);
 
+//! \brief Draws with the specialized renderer of (cfp_p, i2c_p), or draw_fractal_indirect
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   float cx_0, float cy_0, float delta, uint16_t n_max);
+//! \brief Draws calling cfp_p and i2c_p through the pointers for every pixel
+void draw_fractal_indirect(rgb565 *fbuf, int width, int height,
+                           calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                           float cx_0, float cy_0, float delta, uint16_t n_max);
 
 #endif // FRACTAL_FLPT_H
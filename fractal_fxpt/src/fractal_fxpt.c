@@ -11,12 +11,19 @@
     putchar('\n');                                               \
   } while (0)
 
+//! Iterations performed by the point calculation functions
+uint32_t mandelbrot_iterations;
+
+//! Kernels and colour mappings are inlined into the specialized renderers of draw_fractal,
+//! and still defined for the function pointers
+#define FRACTAL_INLINE inline __attribute__((always_inline))
+
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
 //! \param  cy    y-coordinate
 //! \param  n_max maximum number of iterations
 //! \return       number of performed iterations at coordinate (cx, cy)
-uint16_t calc_mandelbrot_point_soft(fxpt_7_25 cx, fxpt_7_25 cy, uint16_t n_max) {
+FRACTAL_INLINE uint16_t calc_mandelbrot_point_soft(fxpt_7_25 cx, fxpt_7_25 cy, uint16_t n_max) {
   fxpt_7_25 x = cx;
   fxpt_7_25 y = cy;
   uint16_t n = 0;
@@ -34,6 +41,76 @@ uint16_t calc_mandelbrot_point_soft(fxpt_7_25 cx, fxpt_7_25 cy, uint16_t n_max)
     ++n;
   } while ((xx + yy) < threshold && (n < n_max));
 
+  mandelbrot_iterations += n;
+  return n;
+}
+
+//! One in Q7.25
+#define FXPT_ONE (1 << 25)
+
+//! \brief  Tells whether (cx, cy) is in the main cardioid or in the period-2 bulb
+static int in_cardioid_or_bulb(fxpt_7_25 cx, fxpt_7_25 cy) {
+  /* bounding box of both regions: -1.25 <= cx <= 0.375, |cy| <= 0.75 */
+  if (cx < -(FXPT_ONE + FXPT_ONE / 4) || cx > 3 * FXPT_ONE / 8 || cy < -3 * FXPT_ONE / 4 || cy > 3 * FXPT_ONE / 4)
+    return 0;
+
+  fxpt_7_25 yy = mul(cy, cy);
+
+  /* cardioid: q (q + x - 1/4) < y^2 / 4 with q = (x - 1/4)^2 + y^2 */
+  fxpt_7_25 xq = cx - FXPT_ONE / 4;
+  fxpt_7_25 q = mul(xq, xq) + yy;
+  if (mul(q, q + xq) < yy >> 2)
+    return 1;
+
+  /* period-2 bulb: (x + 1)^2 + y^2 < 1/16 */
+  fxpt_7_25 xb = cx + FXPT_ONE;
+  return mul(xb, xb) + yy < FXPT_ONE / 16;
+}
+
+//! \brief  Mandelbrot fractal point calculation function, skipping interior points
+//!
+//! Same result as calc_mandelbrot_point_soft. Points of the main cardioid and of the
+//! period-2 bulb return n_max without iterating, and the orbit of the other points
+//! is checked for cycles (Brent): a point whose orbit repeats exactly never escapes.
+//! \param  cx    x-coordinate
+//! \param  cy    y-coordinate
+//! \param  n_max maximum number of iterations
+//! \return       number of iterations of calc_mandelbrot_point_soft at coordinate (cx, cy)
+FRACTAL_INLINE uint16_t calc_mandelbrot_point_fast(fxpt_7_25 cx, fxpt_7_25 cy, uint16_t n_max) {
+  if (in_cardioid_or_bulb(cx, cy))
+    return n_max;
+
+  fxpt_7_25 x = cx;
+  fxpt_7_25 y = cy;
+  fxpt_7_25 x_saved = x, y_saved = y;
+  uint32_t period = 1, steps = 0;
+  uint16_t n = 0;
+  fxpt_7_25 xx, yy, two_xy;
+
+  fxpt_7_25 threshold = 4 * FXPT_ONE;
+
+  do {
+    xx = mul(x, x);
+    yy = mul(y, y);
+    two_xy = mul(x, y) << 1;
+
+    x = xx - yy + cx;
+    y = two_xy + cy;
+    ++n;
+
+    if (x == x_saved && y == y_saved) {
+      mandelbrot_iterations += n;
+      return n_max;
+    }
+    if (++steps == period) {
+      x_saved = x;
+      y_saved = y;
+      period <<= 1;
+      steps = 0;
+    }
+  } while ((xx + yy) < threshold && (n < n_max));
+
+  mandelbrot_iterations += n;
   return n;
 }
 
@@ -41,7 +118,7 @@ uint16_t calc_mandelbrot_point_soft(fxpt_7_25 cx, fxpt_7_25 cy, uint16_t n_max)
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -52,7 +129,7 @@ rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -78,7 +155,7 @@ int ilog2(unsigned x) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return colour in rgb565 format little Endian (big Endian for openrisc)
-rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -100,7 +177,9 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0xf) << 12) | ((g & 0xf) << 7) | ((b & 0xf)<<1));
 }
 
-//! \brief  Draw fractal into frame buffer
+//! \brief  Draw fractal into frame buffer, calling cfp_p and i2c_p for every pixel
+//! \note   Reference of the specialized renderers of draw_fractal, and fallback for
+//!         the functions without one
 //! \param  width  width of frame buffer
 //! \param  height height of frame buffer
 //! \param  cfp_p  pointer to fractal function
@@ -109,9 +188,9 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 //! \param  cy_0   start y-coordinate
 //! \param  delta  increment for x- and y-coordinate
 //! \param  n_max  maximum number of iterations
-void draw_fractal(rgb565 *fbuf, int width, int height,
-                  calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
-                  fxpt_7_25 cx_0, fxpt_7_25 cy_0, fxpt_7_25 delta, uint16_t n_max) {
+void draw_fractal_indirect(rgb565 *fbuf, int width, int height,
+                           calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                           fxpt_7_25 cx_0, fxpt_7_25 cy_0, fxpt_7_25 delta, uint16_t n_max) {
   rgb565 *pixel = fbuf;
   fxpt_7_25 cy = cy_0;
 
@@ -127,6 +206,79 @@ void draw_fractal(rgb565 *fbuf, int width, int height,
   }
 }
 
+//! \brief Renderer with the point calculation and colour mapping functions bound at compile time
+typedef void (*draw_fractal_fixed_p)(rgb565 *fbuf, int width, int height,
+                                     fxpt_7_25 cx_0, fxpt_7_25 cy_0, fxpt_7_25 delta, uint16_t n_max);
+
+//! \brief Defines draw_fractal_<cfp>_<i2c>: the loop of draw_fractal_indirect with cfp and i2c
+//!        called by name, so that both are inlined, and two pixels per iteration.
+//!        The pixels are stepped one delta at a time, as in draw_fractal_indirect.
+#define DEFINE_DRAW_FRACTAL(cfp, i2c)                                                           \
+  static void draw_fractal_##cfp##_##i2c(rgb565 *fbuf, int width, int height, fxpt_7_25 cx_0,   \
+                                         fxpt_7_25 cy_0, fxpt_7_25 delta, uint16_t n_max) {     \
+    rgb565 *pixel = fbuf;                                                                       \
+    fxpt_7_25 cy = cy_0;                                                                        \
+    for (int k = 0; k < height; ++k) {                                                          \
+      fxpt_7_25 cx = cx_0;                                                                      \
+      int i = 0;                                                                                \
+      for (; i + 1 < width; i += 2) {                                                           \
+        fxpt_7_25 cx1 = cx + delta;                                                             \
+        pixel[0] = i2c(cfp(cx, cy, n_max), n_max);                                              \
+        pixel[1] = i2c(cfp(cx1, cy, n_max), n_max);                                             \
+        pixel += 2;                                                                             \
+        cx = cx1 + delta;                                                                       \
+      }                                                                                         \
+      if (i < width)                                                                            \
+        *(pixel++) = i2c(cfp(cx, cy, n_max), n_max);                                            \
+      cy += delta;                                                                              \
+    }                                                                                           \
+  }
+
+//! \brief (point calculation, colour mapping) pairs with a specialized renderer
+#define DRAW_FRACTAL_VARIANTS(X)                            \
+  X(calc_mandelbrot_point_soft, iter_to_bw)                 \
+  X(calc_mandelbrot_point_soft, iter_to_grayscale)          \
+  X(calc_mandelbrot_point_soft, iter_to_colour)             \
+  X(calc_mandelbrot_point_fast, iter_to_bw)                 \
+  X(calc_mandelbrot_point_fast, iter_to_grayscale)          \
+  X(calc_mandelbrot_point_fast, iter_to_colour)
+
+DRAW_FRACTAL_VARIANTS(DEFINE_DRAW_FRACTAL)
+
+#define DRAW_FRACTAL_VARIANT(cfp, i2c) { &cfp, &i2c, &draw_fractal_##cfp##_##i2c },
+
+static const struct {
+  calc_frac_point_p cfp_p;
+  iter_to_colour_p i2c_p;
+  draw_fractal_fixed_p draw;
+} draw_fractal_variants[] = {
+  DRAW_FRACTAL_VARIANTS(DRAW_FRACTAL_VARIANT)
+};
+
+//! \brief  Draw fractal into frame buffer
+//! \note   Runs the specialized renderer of (cfp_p, i2c_p) if DRAW_FRACTAL_VARIANTS lists
+//!         the pair
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  cfp_p  pointer to fractal function
+//! \param  i2c_p  pointer to function mapping number of iterations to colour
+//! \param  cx_0   start x-coordinate
+//! \param  cy_0   start y-coordinate
+//! \param  delta  increment for x- and y-coordinate
+//! \param  n_max  maximum number of iterations
+void draw_fractal(rgb565 *fbuf, int width, int height,
+                  calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                  fxpt_7_25 cx_0, fxpt_7_25 cy_0, fxpt_7_25 delta, uint16_t n_max) {
+  /* the specialized renderer of the pair, if any */
+  for (unsigned v = 0; v < sizeof(draw_fractal_variants) / sizeof(draw_fractal_variants[0]); v++) {
+    if (draw_fractal_variants[v].cfp_p == cfp_p && draw_fractal_variants[v].i2c_p == i2c_p) {
+      draw_fractal_variants[v].draw(fbuf, width, height, cx_0, cy_0, delta, n_max);
+      return;
+    }
+  }
+  draw_fractal_indirect(fbuf, width, height, cfp_p, i2c_p, cx_0, cy_0, delta, n_max);
+}
+
 // ==================================================================================
 
 uint32_t SIGN_MASK = 0x80000000;
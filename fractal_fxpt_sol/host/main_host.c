@@ -0,0 +1,65 @@
+// Host check of draw_fractal_subdiv against draw_fractal, see `make host`
+#include "fractal_fxpt.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SCREEN_WIDTH 512   //!< screen width
+#define SCREEN_HEIGHT 512  //!< screen height
+
+static rgb565 brute[SCREEN_WIDTH * SCREEN_HEIGHT];
+static rgb565 subdiv[SCREEN_WIDTH * SCREEN_HEIGHT];
+static uint16_t iters[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+//! \brief Converts a Q4.28 value given as a decimal number
+static fxpt_4_28 parse_fxpt(const char *s) {
+   return (fxpt_4_28)(strtod(s, NULL) * (1 << 28));
+}
+
+//! \brief Writes a frame buffer as a binary PPM
+static int write_ppm(const char *path, const rgb565 *fbuf) {
+   FILE *f = fopen(path, "wb");
+   if (!f) {
+      perror(path);
+      return -1;
+   }
+   fprintf(f, "P6\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+   for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+      uint16_t c = __builtin_bswap16(fbuf[i]);  // the frame buffer is big endian
+      unsigned char rgb[3] = { (c >> 11) << 3, ((c >> 5) & 0x3f) << 2, (c & 0x1f) << 3 };
+      fwrite(rgb, 1, 3, f);
+   }
+   fclose(f);
+   return 0;
+}
+
+//! usage: main_host [cx_0 cy_0 width n_max], default view if omitted
+int main(int argc, char **argv) {
+   fxpt_4_28 cx_0 = 0xe0000000, cy_0 = 0xe8000000, frac_width = 0x30000000;
+   uint16_t n_max = 64;
+
+   if (argc == 5) {
+      cx_0 = parse_fxpt(argv[1]);
+      cy_0 = parse_fxpt(argv[2]);
+      frac_width = parse_fxpt(argv[3]);
+      n_max = atoi(argv[4]);
+   }
+   fxpt_4_28 delta = frac_width / SCREEN_WIDTH;
+
+   draw_fractal(brute, SCREEN_WIDTH, SCREEN_HEIGHT, &calc_mandelbrot_point_soft, &iter_to_colour,
+                cx_0, cy_0, delta, n_max);
+   uint32_t computed = draw_fractal_subdiv(subdiv, iters, SCREEN_WIDTH, SCREEN_HEIGHT,
+                                           &calc_mandelbrot_point_soft, &iter_to_colour,
+                                           cx_0, cy_0, delta, n_max);
+
+   if (write_ppm("build-host/brute.ppm", brute) || write_ppm("build-host/subdiv.ppm", subdiv))
+      return 2;
+
+   int diff = 0;
+   for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++)
+      diff += brute[i] != subdiv[i];
+
+   printf("computed %u of %d points (%u.%02u%%), %d pixels differ\n", computed, SCREEN_WIDTH * SCREEN_HEIGHT,
+          computed * 100 / (SCREEN_WIDTH * SCREEN_HEIGHT), computed * 10000 / (SCREEN_WIDTH * SCREEN_HEIGHT) % 100,
+          diff);
+   return diff != 0;
+}
@@ -0,0 +1,15 @@
+// Host replacement of support/include/swap.h, which uses a custom instruction
+#ifndef SWAP_H_INCLUDED
+#define SWAP_H_INCLUDED
+
+#include <stdint.h>
+
+static inline uint32_t swap_u32(uint32_t src) {
+   return __builtin_bswap32(src);
+}
+
+static inline uint16_t swap_u16(uint16_t src) {
+   return __builtin_bswap16(src);
+}
+
+#endif /* SWAP_H_INCLUDED */
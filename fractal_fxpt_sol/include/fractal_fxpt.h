@@ -23,8 +23,23 @@ rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max);
 
+//! \brief Draws with the specialized renderer of (cfp_p, i2c_p), or draw_fractal_indirect
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
+//! \brief Draws calling cfp_p and i2c_p through the pointers for every pixel
+void draw_fractal_indirect(rgb565 *fbuf, int width, int height,
+                           calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                           fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
+
+#ifndef SUBDIV_MIN_INSIDE_FILL
+//! Smallest interior side of a rectangle filled with points of the set (n_max iterations),
+//! the border of smaller ones can enclose escaping points at this resolution
+#define SUBDIV_MIN_INSIDE_FILL 8
+#endif
+
+uint32_t draw_fractal_subdiv(rgb565 *fbuf, uint16_t *iters, int width, int height,
+                             calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                             fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
 
 #endif // FRACTAL_FXPT_H
@@ -1,12 +1,17 @@
 #include "fractal_fxpt.h"
 #include "swap.h"
+#include <perf_scope.h>
+
+//! Kernels and colour mappings are inlined into the specialized renderers of draw_fractal,
+//! and still defined for the function pointers
+#define FRACTAL_INLINE inline __attribute__((always_inline))
 
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
 //! \param  cy    y-coordinate
 //! \param  n_max maximum number of iterations
 //! \return       number of performed iterations at coordinate (cx, cy)
-uint16_t calc_mandelbrot_point_soft(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max) {
+FRACTAL_INLINE uint16_t calc_mandelbrot_point_soft(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max) {
   fxpt_4_28 x = cx;
   fxpt_4_28 y = cy;
   uint16_t n = 0;
@@ -35,7 +40,7 @@ uint16_t calc_mandelbrot_point_soft(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max)
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -47,7 +52,7 @@ rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -74,7 +79,7 @@ int ilog2(unsigned x) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return colour in rgb565 format little Endian (big Endian for openrisc)
-rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -97,7 +102,9 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 }
 
 
-//! \brief  Draw fractal into frame buffer
+//! \brief  Draw fractal into frame buffer, calling cfp_p and i2c_p for every pixel
+//! \note   Reference of the specialized renderers of draw_fractal, and fallback for
+//!         the functions without one
 //! \param  width  width of frame buffer
 //! \param  height height of frame buffer
 //! \param  cfp_p  pointer to fractal function
@@ -106,12 +113,13 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 //! \param  cy_0   start y-coordinate
 //! \param  delta  increment for x- and y-coordinate
 //! \param  n_max  maximum number of iterations
-void draw_fractal(rgb565 *fbuf, int width, int height,
-                  calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
-                  fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+void draw_fractal_indirect(rgb565 *fbuf, int width, int height,
+                           calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                           fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
   rgb565 *pixel = fbuf;
   fxpt_4_28 cy = cy_0;
   for (int k = 0; k < height; ++k) {
+    PERF_SCOPE("row");
     fxpt_4_28 cx = cx_0;
     for(int i = 0; i < width; ++i) {
       uint16_t n_iter = (*cfp_p)(cx, cy, n_max);
@@ -122,3 +130,163 @@ void draw_fractal(rgb565 *fbuf, int width, int height,
     cy += delta;
   }
 }
+
+//! \brief Renderer with the point calculation and colour mapping functions bound at compile time
+typedef void (*draw_fractal_fixed_p)(rgb565 *fbuf, int width, int height,
+                                     fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
+
+//! \brief Defines draw_fractal_<cfp>_<i2c>: the loop of draw_fractal_indirect with cfp and i2c
+//!        called by name, so that both are inlined, and two pixels per iteration.
+//!        The pixels are stepped one delta at a time, as in draw_fractal_indirect.
+#define DEFINE_DRAW_FRACTAL(cfp, i2c)                                                           \
+  static void draw_fractal_##cfp##_##i2c(rgb565 *fbuf, int width, int height, fxpt_4_28 cx_0,   \
+                                         fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {     \
+    rgb565 *pixel = fbuf;                                                                       \
+    fxpt_4_28 cy = cy_0;                                                                        \
+    for (int k = 0; k < height; ++k) {                                                          \
+      PERF_SCOPE("row");                                                                        \
+      fxpt_4_28 cx = cx_0;                                                                      \
+      int i = 0;                                                                                \
+      for (; i + 1 < width; i += 2) {                                                           \
+        fxpt_4_28 cx1 = cx + delta;                                                             \
+        pixel[0] = i2c(cfp(cx, cy, n_max), n_max);                                              \
+        pixel[1] = i2c(cfp(cx1, cy, n_max), n_max);                                             \
+        pixel += 2;                                                                             \
+        cx = cx1 + delta;                                                                       \
+      }                                                                                         \
+      if (i < width)                                                                            \
+        *(pixel++) = i2c(cfp(cx, cy, n_max), n_max);                                            \
+      cy += delta;                                                                              \
+    }                                                                                           \
+  }
+
+//! \brief (point calculation, colour mapping) pairs with a specialized renderer
+#define DRAW_FRACTAL_VARIANTS(X)                            \
+  X(calc_mandelbrot_point_soft, iter_to_bw)                 \
+  X(calc_mandelbrot_point_soft, iter_to_grayscale)          \
+  X(calc_mandelbrot_point_soft, iter_to_colour)
+
+DRAW_FRACTAL_VARIANTS(DEFINE_DRAW_FRACTAL)
+
+#define DRAW_FRACTAL_VARIANT(cfp, i2c) { &cfp, &i2c, &draw_fractal_##cfp##_##i2c },
+
+static const struct {
+  calc_frac_point_p cfp_p;
+  iter_to_colour_p i2c_p;
+  draw_fractal_fixed_p draw;
+} draw_fractal_variants[] = {
+  DRAW_FRACTAL_VARIANTS(DRAW_FRACTAL_VARIANT)
+};
+
+//! \brief  Draw fractal into frame buffer
+//! \note   Runs the specialized renderer of (cfp_p, i2c_p) if DRAW_FRACTAL_VARIANTS lists
+//!         the pair
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  cfp_p  pointer to fractal function
+//! \param  i2c_p  pointer to function mapping number of iterations to colour
+//! \param  cx_0   start x-coordinate
+//! \param  cy_0   start y-coordinate
+//! \param  delta  increment for x- and y-coordinate
+//! \param  n_max  maximum number of iterations
+void draw_fractal(rgb565 *fbuf, int width, int height,
+                  calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                  fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+  PERF_SCOPE("draw_fractal");
+  /* the specialized renderer of the pair, if any */
+  for (unsigned v = 0; v < sizeof(draw_fractal_variants) / sizeof(draw_fractal_variants[0]); v++) {
+    if (draw_fractal_variants[v].cfp_p == cfp_p && draw_fractal_variants[v].i2c_p == i2c_p) {
+      draw_fractal_variants[v].draw(fbuf, width, height, cx_0, cy_0, delta, n_max);
+      return;
+    }
+  }
+  draw_fractal_indirect(fbuf, width, height, cfp_p, i2c_p, cx_0, cy_0, delta, n_max);
+}
+
+//! \brief State of a subdivision render
+struct subdiv {
+  rgb565 *fbuf;
+  uint16_t *iters;
+  int width;
+  calc_frac_point_p cfp_p;
+  iter_to_colour_p i2c_p;
+  fxpt_4_28 cx_0, cy_0, delta;
+  uint16_t n_max;
+  uint32_t computed;
+};
+
+//! \brief Iterations at pixel (x, y), computed on the first access
+static uint16_t subdiv_point(struct subdiv *s, int x, int y) {
+  uint16_t *iter = &s->iters[y * s->width + x];
+  if (*iter == 0) {
+    /* the kernels perform at least one iteration, 0 means not computed */
+    *iter = (*s->cfp_p)(s->cx_0 + x * s->delta, s->cy_0 + y * s->delta, s->n_max);
+    s->fbuf[y * s->width + x] = (*s->i2c_p)(*iter, s->n_max);
+    s->computed++;
+  }
+  return *iter;
+}
+
+//! \brief Renders the rectangle [x0, x1] x [y0, y1], bounds included
+static void subdiv_rect(struct subdiv *s, int x0, int y0, int x1, int y1) {
+  uint16_t n = subdiv_point(s, x0, y0);
+  int uniform = 1;
+
+  for (int x = x0; x <= x1; ++x) {
+    uniform &= subdiv_point(s, x, y0) == n;
+    uniform &= subdiv_point(s, x, y1) == n;
+  }
+  for (int y = y0 + 1; y < y1; ++y) {
+    uniform &= subdiv_point(s, x0, y) == n;
+    uniform &= subdiv_point(s, x1, y) == n;
+  }
+
+  if (x1 - x0 < 2 || y1 - y0 < 2)
+    return;  // no interior
+
+  int inside_fill = x1 - x0 > SUBDIV_MIN_INSIDE_FILL && y1 - y0 > SUBDIV_MIN_INSIDE_FILL;
+  if (uniform && (n != s->n_max || inside_fill)) {
+    rgb565 colour = (*s->i2c_p)(n, s->n_max);
+    for (int y = y0 + 1; y < y1; ++y) {
+      for (int x = x0 + 1; x < x1; ++x) {
+        s->iters[y * s->width + x] = n;
+        s->fbuf[y * s->width + x] = colour;
+      }
+    }
+    return;
+  }
+
+  /* split the longer side, the halves share the middle line */
+  if (x1 - x0 >= y1 - y0) {
+    int xm = (x0 + x1) / 2;
+    subdiv_rect(s, x0, y0, xm, y1);
+    subdiv_rect(s, xm, y0, x1, y1);
+  } else {
+    int ym = (y0 + y1) / 2;
+    subdiv_rect(s, x0, y0, x1, ym);
+    subdiv_rect(s, x0, ym, x1, y1);
+  }
+}
+
+//! \brief  Draw fractal into frame buffer by rectangle subdivision (Mariani-Silver)
+//!
+//! The border of a rectangle is computed first. If every border point has the same
+//! number of iterations, the interior is filled with its colour, otherwise the
+//! rectangle is split in two and each half is processed the same way. Points of
+//! the set are only filled in rectangles larger than SUBDIV_MIN_INSIDE_FILL, so
+//! that the frame is the one of draw_fractal (checked on the host, `make host`).
+//! \param  iters  scratch buffer of width * height iteration counts
+//! \return        number of points actually computed
+//! \note   The other parameters are the ones of draw_fractal
+uint32_t draw_fractal_subdiv(rgb565 *fbuf, uint16_t *iters, int width, int height,
+                             calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                             fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+  PERF_SCOPE("draw_fractal_subdiv");
+  struct subdiv s = { fbuf, iters, width, cfp_p, i2c_p, cx_0, cy_0, delta, n_max, 0 };
+
+  for (int i = 0; i < width * height; ++i)
+    iters[i] = 0;
+
+  subdiv_rect(&s, 0, 0, width - 1, height - 1);
+  return s.computed;
+}
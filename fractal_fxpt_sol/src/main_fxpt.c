@@ -5,7 +5,11 @@
 #include <stdio.h>
 #ifdef __OR1300__
 #include "perf.h"
+#include "perf_scope.h"
 #include "cache.h"
+#include <dma_copy.h>
+#include <platform.h>
+#include <profiler.h>
 #include <spr.h>
 #include <exception.h>
 #endif
@@ -22,6 +26,39 @@ const rgb565 N_MAX = 64;                 //!< maximum number of iterations
 
 volatile rgb565 frameBuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
 
+#ifdef __OR1300__
+//! Iteration counts of the subdivision renderer
+static uint16_t iterBuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+//! \brief Checksum of the frame buffer, to compare the renderers
+static uint32_t frame_checksum(void) {
+   uint32_t sum = 0;
+   dcache_flush();
+   for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++)
+      sum = (sum << 1 | sum >> 31) ^ frameBuffer[i];
+   return sum;
+}
+
+//! \brief Prints the cycles per pixel of a frame drawn through the function pointers
+//!        (draw_fractal_indirect) and by the specialized renderer of draw_fractal
+static void print_cycles_per_pixel(const char *kernel, rgb565 *fbuf, calc_frac_point_p cfp_p,
+                                   fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta) {
+   const uint64_t pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+   perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_indirect(fbuf,SCREEN_WIDTH,SCREEN_HEIGHT,cfp_p,&iter_to_colour,cx_0,cy_0,delta,N_MAX);
+   perf_cycles_t indirect = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+   start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(fbuf,SCREEN_WIDTH,SCREEN_HEIGHT,cfp_p,&iter_to_colour,cx_0,cy_0,delta,N_MAX);
+   perf_cycles_t specialized = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+   printf("cycles_per_pixel,%s,%llu.%02llu,%llu.%02llu\n", kernel,
+          indirect / pixels, indirect * 100 / pixels % 100,
+          specialized / pixels, specialized * 100 / pixels % 100);
+}
+#endif
+
 // Some exception handler
 void my_trap_handler(void) {
    printf("I just caught a trap! Ahaha!!!\n");
@@ -37,6 +74,23 @@ void my_syscall_handler(void) {
    printf("Instruction : %08x\n", * (epc - 1 ));
 }
 
+#ifdef __OR1300__
+//! \brief Prints the counters of the fractal drawing
+static void print_report(void) {
+   perf_print_cycles(PERF_COUNTER_0, "Stall cycles    ");
+   perf_print_cycles(PERF_COUNTER_1, "Bus idle cycles ");
+   perf_print_cycles(PERF_COUNTER_2, "Instruction cache fetches ");
+   perf_print_cycles(PERF_COUNTER_3, "Instruction cache misses ");
+   perf_print_cycles(PERF_COUNTER_RUNTIME, "Runtime cycles  ");
+
+   perf_print_time(PERF_COUNTER_0, "Stall cycles    ");
+   perf_print_time(PERF_COUNTER_1, "Bus idle cycles ");
+   // perf_print_time(PERF_COUNTER_2, "Instruction cache fetches ");
+   // perf_print_time(PERF_COUNTER_3, "Instruction cache misses ");
+   perf_print_time(PERF_COUNTER_RUNTIME, "Runtime cycles  ");
+}
+#endif
+
 int main() {
 
 #ifdef __OR1300__  
@@ -45,6 +99,11 @@ int main() {
 
    SYSCALL(0xAA);
 
+#ifdef __OR1300__
+   /* single CPU, and the only printing handler is the system call above */
+   stdout_set_mode(STDOUT_LINE_BUFFERED);
+#endif
+
    volatile unsigned int *vga = (unsigned int *) 0X50000020;
    volatile unsigned int reg, hi;
    fxpt_4_28 delta = FRAC_WIDTH / SCREEN_WIDTH;
@@ -63,6 +122,7 @@ int main() {
    perf_set_mask(PERF_COUNTER_1, PERF_BUS_IDLE_MASK);
    perf_set_mask(PERF_COUNTER_2, PERF_INSTRUCTION_FETCH_MASK);
    perf_set_mask(PERF_COUNTER_3, PERF_ICACHE_MISS_MASK);
+   perf_set_mask(PERF_SCOPE_COUNTER, PERF_DCACHE_MISS_MASK);
 
    perf_memdist_set(0);
    
@@ -73,27 +133,52 @@ int main() {
    vga[2] = swap_u32(1);
    vga[3] = swap_u32((unsigned int)&frameBuffer[0]);
    /* Clear screen */
+#ifdef __OR1300__
+   dma_memset((void *)frameBuffer, 0, sizeof(frameBuffer));
+#else
    for (i = 0 ; i < SCREEN_WIDTH*SCREEN_HEIGHT ; i++) frameBuffer[i]=0;
+#endif
 #ifdef __OR1300__   
    perf_start();
 #endif
    draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
 #ifdef __OR1300__
    perf_stop();   
+   /* the report below starts and stops the counters again */
+   uint64_t brute = perf_read_counter(PERF_COUNTER_RUNTIME);
    printf("Done\n");
    
-   perf_print_cycles(PERF_COUNTER_0, "Stall cycles    ");
-   perf_print_cycles(PERF_COUNTER_1, "Bus idle cycles ");
-   perf_print_cycles(PERF_COUNTER_2, "Instruction cache fetches ");
-   perf_print_cycles(PERF_COUNTER_3, "Instruction cache misses ");
-   perf_print_cycles(PERF_COUNTER_RUNTIME, "Runtime cycles  ");
+   print_report();
 
-   perf_print_time(PERF_COUNTER_0, "Stall cycles    ");
-   perf_print_time(PERF_COUNTER_1, "Bus idle cycles ");
-   // perf_print_time(PERF_COUNTER_2, "Instruction cache fetches ");
-   // perf_print_time(PERF_COUNTER_3, "Instruction cache misses ");
-   perf_print_time(PERF_COUNTER_RUNTIME, "Runtime cycles  ");
-   dcache_flush();
+   perf_scope_dump(1);
+   stdout_benchmark("fractal_report", &print_report);
+
+   /* same frame by rectangle subdivision */
+   uint32_t reference = frame_checksum();
+   dma_memset((void *)frameBuffer, 0, sizeof(frameBuffer));
+   perf_start();
+   uint64_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   uint32_t computed = draw_fractal_subdiv((rgb565 *)frameBuffer, iterBuffer, SCREEN_WIDTH, SCREEN_HEIGHT,
+                                           &calc_mandelbrot_point_soft, &iter_to_colour, CX_0, CY_0, delta, N_MAX);
+   uint64_t subdiv = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+   perf_stop();
+   uint32_t sum = frame_checksum();
+
+   printf("subdiv,pixels,computed,brute_cycles,subdiv_cycles,checksum\n");
+   printf("subdiv,%d,%u,%llu,%llu,%08X%s\n", SCREEN_WIDTH * SCREEN_HEIGHT, computed, brute, subdiv,
+          sum, sum == reference ? "" : " MISMATCH");
+
+   perf_start();
+   printf("cycles_per_pixel,kernel,indirect,specialized\n");
+   print_cycles_per_pixel("soft",(rgb565 *)frameBuffer,&calc_mandelbrot_point_soft,CX_0,CY_0,delta);
+   perf_stop();
+
+   /* PC histogram of draw_fractal, mapped to functions by support/tools/profile.py.
+      Last, since the sampling interrupts stop the performance counters */
+   profiler_start(PROFILER_DEFAULT_PERIOD);
+   draw_fractal((rgb565 *)frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft,&iter_to_colour,CX_0,CY_0,delta,N_MAX);
+   profiler_stop();
+   profiler_dump(1);
 #endif
 }
 
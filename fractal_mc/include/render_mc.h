@@ -0,0 +1,38 @@
+#ifndef RENDER_MC_H
+#define RENDER_MC_H
+
+#include <main.h>
+
+//! Number of rows of a band, the unit of work handed to a CPU
+#define MC_BAND_ROWS 4
+
+//! Number of CPUs: CPU1 is 0, CPU2 is 1 and CPU3 is 2
+#define MC_MAX_CPUS 3
+
+//! Lock protecting the work counter
+#define MC_WORK_LOCK_ID 1
+
+//! \brief Fractal point kernels of the parallel renderer
+enum mc_kernel {
+  MC_KERNEL_SOFT,    //!< calc_mandelbrot_point_soft and iter_to_colour
+  MC_KERNEL_CUSTOM,  //!< custom instruction, two pixels per call
+};
+
+//! \brief Per-CPU statistics of the last frame
+struct mc_cpu_stats {
+  uint32_t bands;   //!< number of bands rendered
+  uint64_t cycles;  //!< cycles from the start of the frame to the last band
+};
+
+//! \brief Starts CPU2 and CPU3, which wait for frames. Call once, after init_locks.
+void mc_start_workers();
+
+//! \brief Renders a frame with the given number of CPUs (1 to 3) and waits for it
+//! \return cycles of the frame, as seen by CPU1
+uint64_t mc_draw_fractal(rgb565 *fbuf, enum mc_kernel kernel, int cpus,
+                         fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
+
+//! \brief Statistics of a CPU (0 to 2) for the last frame
+const struct mc_cpu_stats *mc_stats(int cpu);
+
+#endif // RENDER_MC_H
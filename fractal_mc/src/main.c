@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <cache.h>
+#include <locks.h>
+#include <perf.h>
+#include <platform.h>
+#include <swap.h>
+#include <vga.h>
+#include <main.h>
+#include <render_mc.h>
+
+rgb565 frameBuffer[SCREEN_WIDTH*SCREEN_HEIGHT] __attribute__((aligned(32)));
+
+static const char *kernel_names[] = { "soft", "custom" };
+
+//! \brief Checksum of the frame buffer, to check that every CPU count draws the same frame
+static uint32_t checksum() {
+  uint32_t sum = 0;
+  dcache_flush();
+  for (int i = 0; i < SCREEN_WIDTH*SCREEN_HEIGHT; i++)
+    sum = (sum << 1 | sum >> 31) ^ frameBuffer[i];
+  return sum;
+}
+
+int main() {
+   volatile unsigned int *vga = (unsigned int *) 0X50000020;
+   fxpt_4_28 delta = FRAC_WIDTH / SCREEN_WIDTH;
+
+   platform_init();
+   perf_init();
+   init_locks();
+
+   vga_clear();
+   printf("Starting drawing a fractal on up to %d CPUs\n", MC_MAX_CPUS);
+
+   /* Enable the vga-controller's graphic mode */
+   vga[0] = swap_u32(SCREEN_WIDTH);
+   vga[1] = swap_u32(SCREEN_HEIGHT);
+   vga[3] = swap_u32( (unsigned int) &frameBuffer[0] );
+
+   mc_start_workers();
+
+   printf("mc,kernel,cpus,cycles,speedup,bands_cpu1,bands_cpu2,bands_cpu3,cycles_cpu1,cycles_cpu2,cycles_cpu3,checksum\n");
+   for (int kernel = MC_KERNEL_SOFT; kernel <= MC_KERNEL_CUSTOM; kernel++) {
+      uint64_t single = 0;
+      uint32_t reference = 0;
+
+      for (int cpus = 1; cpus <= MC_MAX_CPUS; cpus++) {
+         uint64_t cycles = mc_draw_fractal(frameBuffer, kernel, cpus, CX_0, CY_0, delta, N_MAX);
+         uint32_t sum = checksum();
+
+         if (cpus == 1) {
+            single = cycles;
+            reference = sum;
+         }
+
+         uint64_t speedup = single * 100 / cycles;
+         printf("mc,%s,%d,%llu,%llu.%02llu,%u,%u,%u,%llu,%llu,%llu,%08X%s\n", kernel_names[kernel], cpus, cycles,
+                speedup / 100, speedup % 100,
+                mc_stats(0)->bands, mc_stats(1)->bands, mc_stats(2)->bands,
+                mc_stats(0)->cycles, mc_stats(1)->cycles, mc_stats(2)->cycles,
+                sum, sum == reference ? "" : " MISMATCH");
+      }
+   }
+
+   printf("Done\n");
+   return 0;
+}
@@ -0,0 +1,166 @@
+#include <render_mc.h>
+#include <fractal_fxpt.h>
+#include <cache.h>
+#include <cpu2.h>
+#include <cpu3.h>
+#include <defs.h>
+#include <locks.h>
+#include <perf.h>
+
+//! Data cache of every CPU: coherent, so that the work counter and the frame description are shared
+#define MC_DCACHE_CFG (CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK | CACHE_COHERENCE | CACHE_MESI)
+
+//! \brief Frame shared by the CPUs
+//! \note go and done are sequence numbers: the workers render when go changes
+//!       and publish done = go once their last band is written back.
+__global static struct {
+  volatile uint32_t go __aligned(32);
+  volatile uint32_t next_band __aligned(32);  //!< work counter, under MC_WORK_LOCK_ID
+  volatile uint32_t done[MC_MAX_CPUS] __aligned(32);
+  rgb565 *fbuf;
+  enum mc_kernel kernel;
+  int cpus;
+  fxpt_4_28 cx_0, cy_0, delta;
+  uint16_t n_max;
+  struct mc_cpu_stats stats[MC_MAX_CPUS];
+} frame;
+
+//! \brief Takes the next band, atomically
+//! \return index of the band, or a value past the last band if the frame is done
+static uint32_t take_band() {
+  get_lock(MC_WORK_LOCK_ID);
+  uint32_t band = frame.next_band++;
+  release_lock(MC_WORK_LOCK_ID);
+  return band;
+}
+
+static void draw_band_soft(int band) {
+  int k0 = band * MC_BAND_ROWS;
+  rgb565 *pixel = frame.fbuf + k0 * SCREEN_WIDTH;
+  fxpt_4_28 cy = frame.cy_0 + k0 * frame.delta;
+
+  for (int k = 0; k < MC_BAND_ROWS; ++k) {
+    fxpt_4_28 cx = frame.cx_0;
+    for (int i = 0; i < SCREEN_WIDTH; ++i) {
+      uint16_t n_iter = calc_mandelbrot_point_soft(cx, cy, frame.n_max);
+      *(pixel++) = iter_to_colour(n_iter, frame.n_max);
+      cx += frame.delta;
+    }
+    cy += frame.delta;
+  }
+}
+
+static void draw_band_custom(int band) {
+  int k0 = band * MC_BAND_ROWS;
+  uint32_t *pixels = (uint32_t *)(frame.fbuf + k0 * SCREEN_WIDTH);
+  fxpt_4_28 cy = frame.cy_0 + k0 * frame.delta;
+  uint32_t color;
+
+  for (int k = 0; k < MC_BAND_ROWS; ++k) {
+    fxpt_4_28 cx = frame.cx_0;
+    for (int i = 0; i < SCREEN_WIDTH; i += 2) {
+      asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
+      *(pixels++) = color;
+      cx += frame.delta << 1;
+    }
+    cy += frame.delta;
+  }
+}
+
+//! \brief Renders bands until the work counter runs out, then writes them back
+static void render_bands(int cpu) {
+  perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+  uint32_t bands = 0;
+
+  if (frame.kernel == MC_KERNEL_CUSTOM) {
+    /* the colour mapping and the step are per CPU */
+    int config = (2 << 16) | frame.n_max;
+    asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(config),[in2]"r"(frame.delta));
+  }
+
+  for (uint32_t band = take_band(); band < SCREEN_HEIGHT / MC_BAND_ROWS; band = take_band()) {
+    if (frame.kernel == MC_KERNEL_CUSTOM)
+      draw_band_custom(band);
+    else
+      draw_band_soft(band);
+    bands++;
+  }
+
+  dcache_flush();
+  frame.stats[cpu].bands = bands;
+  frame.stats[cpu].cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+}
+
+static void setup_cpu() {
+  icache_write_cfg(CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO);
+  dcache_write_cfg(MC_DCACHE_CFG);
+  icache_enable(1);
+  dcache_enable(1);
+  perf_start();
+}
+
+static void worker(int cpu) {
+  uint32_t seq = 0;
+
+  setup_cpu();
+  while (1) {
+    while (frame.go == seq)
+      ;
+    seq = frame.go;
+
+    if (cpu < frame.cpus)
+      render_bands(cpu);
+    frame.done[cpu] = seq;
+  }
+}
+
+void main2() {
+  worker(1);
+}
+
+void main3() {
+  worker(2);
+}
+
+void mc_start_workers() {
+  setup_cpu();
+
+  SET_CPU2_MAIN(&init_cpu2);
+  set_stack_cpu2(1 << 20 /* 1 MB */);
+  START_CPU2();
+
+  SET_CPU3_MAIN(&init_cpu3);
+  set_stack_cpu3(2 << 20 /* 2 MB */);
+  START_CPU3();
+}
+
+uint64_t mc_draw_fractal(rgb565 *fbuf, enum mc_kernel kernel, int cpus,
+                         fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+  perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+
+  for (int c = 0; c < MC_MAX_CPUS; c++) {
+    frame.stats[c].bands = 0;
+    frame.stats[c].cycles = 0;
+  }
+
+  frame.fbuf = fbuf;
+  frame.kernel = kernel;
+  frame.cpus = cpus;
+  frame.cx_0 = cx_0;
+  frame.cy_0 = cy_0;
+  frame.delta = delta;
+  frame.n_max = n_max;
+  frame.next_band = 0;
+  uint32_t seq = ++frame.go;
+
+  render_bands(0);
+  for (int c = 1; c < MC_MAX_CPUS; c++)
+    while (frame.done[c] != seq)
+      ;
+
+  return perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+}
+
+const struct mc_cpu_stats *mc_stats(int cpu) {
+  return &frame.stats[cpu];
+}
@@ -296,12 +296,19 @@ int soft_float_less_than(soft_float32 a, soft_float32 b) {
     return reverse ? (magnitude_a > magnitude_b) : (magnitude_a < magnitude_b);
 }
 
+//! Iterations performed by the point calculation functions
+uint32_t mandelbrot_iterations;
+
+//! Kernels and colour mappings are inlined into the specialized renderers of draw_fractal,
+//! and still defined for the function pointers
+#define FRACTAL_INLINE inline __attribute__((always_inline))
+
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
 //! \param  cy    y-coordinate
 //! \param  n_max maximum number of iterations
 //! \return       number of performed iterations at coordinate (cx, cy)
-uint16_t calc_mandelbrot_point_soft(soft_float32 cx, soft_float32 cy, uint16_t n_max) {
+FRACTAL_INLINE uint16_t calc_mandelbrot_point_soft(soft_float32 cx, soft_float32 cy, uint16_t n_max) {
   soft_float32 x = cx;
   soft_float32 y = cy;
   uint16_t n = 0;
@@ -324,6 +331,91 @@ uint16_t calc_mandelbrot_point_soft(soft_float32 cx, soft_float32 cy, uint16_t n
     //printf("xxplusyy : %x \n", xxplusyy);
     
   } while ((soft_float_less_than(xxplusyy, four)) && (n < n_max));
+  mandelbrot_iterations += n;
+  return n;
+}
+
+// Constants of the interior test in our format
+#define SOFT_FLOAT_QUARTER 0x000000f8     // 0.25
+#define SOFT_FLOAT_ONE 0x000000fa         // 1
+#define SOFT_FLOAT_MINUS_1_25 0xa00000fa  // -1.25
+#define SOFT_FLOAT_0_375 0x400000f8       // 0.375
+#define SOFT_FLOAT_0_75 0x400000f9        // 0.75
+#define SOFT_FLOAT_MINUS_0_65 0xa66666f9  // -0.65
+#define SOFT_FLOAT_0_2 0x4ccccdf7         // 0.2
+#define SOFT_FLOAT_0_0488 0x47e282f5      // 0.0488
+
+//! \brief  Tells whether (cx, cy) is in the main cardioid or in the period-2 bulb
+//! \note   The operations truncate: points close to the boundary converge slowly and
+//!         can escape, so both regions are shrunk (the cardioid test uses y^2 / 5 and
+//!         stops at the neck, the bulb radius is 0.22) to keep the result of
+//!         calc_mandelbrot_point_soft.
+static int in_cardioid_or_bulb(soft_float32 cx, soft_float32 cy) {
+  // Bounding box of both regions: -1.25 <= cx <= 0.375, |cy| <= 0.75
+  if (soft_float_less_than(cx, SOFT_FLOAT_MINUS_1_25) || soft_float_less_than(SOFT_FLOAT_0_375, cx)
+      || soft_float_less_than(SOFT_FLOAT_0_75, set_sign(cy, 0)))
+    return 0;
+
+  soft_float32 yy = soft_float_mul(cy, cy);
+
+  // Cardioid: q (q + x - 1/4) < y^2 / 4 with q = (x - 1/4)^2 + y^2
+  if (soft_float_less_than(SOFT_FLOAT_MINUS_0_65, cx)) {
+    soft_float32 xq = soft_float_add(cx, soft_float_change_sign(SOFT_FLOAT_QUARTER));
+    soft_float32 q = soft_float_add(soft_float_mul(xq, xq), yy);
+    return soft_float_less_than(soft_float_mul(q, soft_float_add(q, xq)), soft_float_mul(yy, SOFT_FLOAT_0_2));
+  }
+
+  // Period-2 bulb: (x + 1)^2 + y^2 < 1/16
+  soft_float32 xb = soft_float_add(cx, SOFT_FLOAT_ONE);
+  return soft_float_less_than(soft_float_add(soft_float_mul(xb, xb), yy), SOFT_FLOAT_0_0488);
+}
+
+//! \brief  Mandelbrot fractal point calculation function, skipping interior points
+//!
+//! Same result as calc_mandelbrot_point_soft. Points of the main cardioid and of the
+//! period-2 bulb return n_max without iterating, and the orbit of the other points
+//! is checked for cycles (Brent): a point whose orbit repeats exactly never escapes.
+//! \param  cx    x-coordinate
+//! \param  cy    y-coordinate
+//! \param  n_max maximum number of iterations
+//! \return       number of iterations of calc_mandelbrot_point_soft at coordinate (cx, cy)
+FRACTAL_INLINE uint16_t calc_mandelbrot_point_fast(soft_float32 cx, soft_float32 cy, uint16_t n_max) {
+  if (in_cardioid_or_bulb(cx, cy))
+    return n_max;
+
+  soft_float32 x = cx;
+  soft_float32 y = cy;
+  // The iteration only depends on (x, y): if they come back, the orbit never escapes
+  soft_float32 x_saved = x, y_saved = y;
+  uint32_t period = 1, steps = 0;
+  uint16_t n = 0;
+  soft_float32 four = 0x000000fc; // 4 in our format is 0x000000fc
+  soft_float32 xx, yy, xy, two_xy, xxyy, minusyy, xxplusyy;
+  do {
+    xx = soft_float_mul(x,x);
+    yy = soft_float_mul(y,y);
+    xy = soft_float_mul(x,y);
+    two_xy = soft_float_mul_two(xy);
+    minusyy = soft_float_change_sign(yy);
+    xxyy = soft_float_add(xx, minusyy);
+    x = soft_float_add(xxyy, cx);
+    y = soft_float_add(two_xy, cy);
+    ++n;
+
+    if (x == x_saved && y == y_saved) {
+      mandelbrot_iterations += n;
+      return n_max;
+    }
+    if (++steps == period) {
+      x_saved = x;
+      y_saved = y;
+      period <<= 1;
+      steps = 0;
+    }
+
+    xxplusyy = soft_float_add(xx,yy);
+  } while ((soft_float_less_than(xxplusyy, four)) && (n < n_max));
+  mandelbrot_iterations += n;
   return n;
 }
 
@@ -332,7 +424,7 @@ uint16_t calc_mandelbrot_point_soft(soft_float32 cx, soft_float32 cy, uint16_t n
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -344,7 +436,7 @@ rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -371,7 +463,7 @@ int ilog2(unsigned x) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return colour in rgb565 format little Endian (big Endian for openrisc)
-rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+FRACTAL_INLINE rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -393,7 +485,9 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0xf) << 12) | ((g & 0xf) << 7) | ((b & 0xf)<<1));
 }
 
-//! \brief  Draw fractal into frame buffer
+//! \brief  Draw fractal into frame buffer, calling cfp_p and i2c_p for every pixel
+//! \note   Reference of the specialized renderers of draw_fractal, and fallback for
+//!         the functions without one
 //! \param  width  width of frame buffer
 //! \param  height height of frame buffer
 //! \param  cfp_p  pointer to fractal function
@@ -402,9 +496,9 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 //! \param  cy_0   start y-coordinate
 //! \param  delta  increment for x- and y-coordinate
 //! \param  n_max  maximum number of iterations
-void draw_fractal(rgb565 *fbuf, int width, int height,
-                  calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
-                  soft_float32 cx_0, soft_float32 cy_0, soft_float32 delta, uint16_t n_max) {
+void draw_fractal_indirect(rgb565 *fbuf, int width, int height,
+                           calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                           soft_float32 cx_0, soft_float32 cy_0, soft_float32 delta, uint16_t n_max) {
   rgb565 *pixel = fbuf;
   soft_float32 cy = cy_0;
   for (int k = 0; k < height; ++k) {
@@ -418,3 +512,76 @@ void draw_fractal(rgb565 *fbuf, int width, int height,
     cy = soft_float_add(cy, delta);
   }
 }
+
+//! \brief Renderer with the point calculation and colour mapping functions bound at compile time
+typedef void (*draw_fractal_fixed_p)(rgb565 *fbuf, int width, int height,
+                                     soft_float32 cx_0, soft_float32 cy_0, soft_float32 delta, uint16_t n_max);
+
+//! \brief Defines draw_fractal_<cfp>_<i2c>: the loop of draw_fractal_indirect with cfp and i2c
+//!        called by name, so that both are inlined, and two pixels per iteration.
+//!        The pixels are stepped one delta at a time, as in draw_fractal_indirect.
+#define DEFINE_DRAW_FRACTAL(cfp, i2c)                                                           \
+  static void draw_fractal_##cfp##_##i2c(rgb565 *fbuf, int width, int height, soft_float32 cx_0,\
+                                         soft_float32 cy_0, soft_float32 delta, uint16_t n_max) {\
+    rgb565 *pixel = fbuf;                                                                       \
+    soft_float32 cy = cy_0;                                                                     \
+    for (int k = 0; k < height; ++k) {                                                          \
+      soft_float32 cx = cx_0;                                                                   \
+      int i = 0;                                                                                \
+      for (; i + 1 < width; i += 2) {                                                           \
+        soft_float32 cx1 = soft_float_add(cx, delta);                                           \
+        pixel[0] = i2c(cfp(cx, cy, n_max), n_max);                                              \
+        pixel[1] = i2c(cfp(cx1, cy, n_max), n_max);                                             \
+        pixel += 2;                                                                             \
+        cx = soft_float_add(cx1, delta);                                                        \
+      }                                                                                         \
+      if (i < width)                                                                            \
+        *(pixel++) = i2c(cfp(cx, cy, n_max), n_max);                                            \
+      cy = soft_float_add(cy, delta);                                                           \
+    }                                                                                           \
+  }
+
+//! \brief (point calculation, colour mapping) pairs with a specialized renderer
+#define DRAW_FRACTAL_VARIANTS(X)                            \
+  X(calc_mandelbrot_point_soft, iter_to_bw)                 \
+  X(calc_mandelbrot_point_soft, iter_to_grayscale)          \
+  X(calc_mandelbrot_point_soft, iter_to_colour)             \
+  X(calc_mandelbrot_point_fast, iter_to_bw)                 \
+  X(calc_mandelbrot_point_fast, iter_to_grayscale)          \
+  X(calc_mandelbrot_point_fast, iter_to_colour)
+
+DRAW_FRACTAL_VARIANTS(DEFINE_DRAW_FRACTAL)
+
+#define DRAW_FRACTAL_VARIANT(cfp, i2c) { &cfp, &i2c, &draw_fractal_##cfp##_##i2c },
+
+static const struct {
+  calc_frac_point_p cfp_p;
+  iter_to_colour_p i2c_p;
+  draw_fractal_fixed_p draw;
+} draw_fractal_variants[] = {
+  DRAW_FRACTAL_VARIANTS(DRAW_FRACTAL_VARIANT)
+};
+
+//! \brief  Draw fractal into frame buffer
+//! \note   Runs the specialized renderer of (cfp_p, i2c_p) if DRAW_FRACTAL_VARIANTS lists
+//!         the pair
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  cfp_p  pointer to fractal function
+//! \param  i2c_p  pointer to function mapping number of iterations to colour
+//! \param  cx_0   start x-coordinate
+//! \param  cy_0   start y-coordinate
+//! \param  delta  increment for x- and y-coordinate
+//! \param  n_max  maximum number of iterations
+void draw_fractal(rgb565 *fbuf, int width, int height,
+                  calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                  soft_float32 cx_0, soft_float32 cy_0, soft_float32 delta, uint16_t n_max) {
+  /* the specialized renderer of the pair, if any */
+  for (unsigned v = 0; v < sizeof(draw_fractal_variants) / sizeof(draw_fractal_variants[0]); v++) {
+    if (draw_fractal_variants[v].cfp_p == cfp_p && draw_fractal_variants[v].i2c_p == i2c_p) {
+      draw_fractal_variants[v].draw(fbuf, width, height, cx_0, cy_0, delta, n_max);
+      return;
+    }
+  }
+  draw_fractal_indirect(fbuf, width, height, cfp_p, i2c_p, cx_0, cy_0, delta, n_max);
+}
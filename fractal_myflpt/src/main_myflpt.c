@@ -4,6 +4,10 @@
 #include "cache.h"
 #include <stddef.h>
 #include <stdio.h>
+#ifdef __OR1300__
+#include "perf.h"
+#include "platform.h"
+#endif
 
 // Constants describing the output device
 const int SCREEN_WIDTH = 512;   //!< screen width
@@ -15,6 +19,27 @@ const float CX_0 = -2.0;      //!< default start x-coordinate (-2.0 in Q4.28)
 const float CY_0 = -1.5;      //!< default start y-coordinate (-1.5 in Q4.28)
 const uint16_t N_MAX = 64;    //!< maximum number of iterations
 
+#ifdef __OR1300__
+//! \brief Prints the cycles per pixel of a frame drawn through the function pointers
+//!        (draw_fractal_indirect) and by the specialized renderer of draw_fractal
+static void print_cycles_per_pixel(const char *kernel, rgb565 *fbuf, calc_frac_point_p cfp_p,
+                                   soft_float32 cx_0, soft_float32 cy_0, soft_float32 delta) {
+   const uint64_t pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+   perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_indirect(fbuf,SCREEN_WIDTH,SCREEN_HEIGHT,cfp_p,&iter_to_colour,cx_0,cy_0,delta,N_MAX);
+   perf_cycles_t indirect = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+   start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(fbuf,SCREEN_WIDTH,SCREEN_HEIGHT,cfp_p,&iter_to_colour,cx_0,cy_0,delta,N_MAX);
+   perf_cycles_t specialized = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+   printf("cycles_per_pixel,%s,%llu.%02llu,%llu.%02llu\n", kernel,
+          indirect / pixels, indirect * 100 / pixels % 100,
+          specialized / pixels, specialized * 100 / pixels % 100);
+}
+#endif
+
 int main() {
    volatile unsigned int *vga = (unsigned int *) 0x50000020;
    volatile unsigned int reg, hi;
@@ -23,6 +48,12 @@ int main() {
    int i;
    vga_clear();
    printf("Starting drawing a fractal\n");
+#ifdef __OR1300__
+   /* single CPU, no printing handler */
+   stdout_set_mode(STDOUT_LINE_BUFFERED);
+   perf_init();
+   perf_start();
+#endif
 #ifdef OR1300   
    /* enable the caches */
    icache_write_cfg( CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO );
@@ -41,6 +72,17 @@ int main() {
    soft_float32 cy0 = float_to_soft_float32(CY_0);
    soft_float32 softdelta = float_to_soft_float32(delta);
    draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,cx0,cy0,softdelta,N_MAX);
+   uint32_t soft_iterations = mandelbrot_iterations;
+
+   /* same frame, skipping the cardioid, the period-2 bulb and the periodic orbits */
+   mandelbrot_iterations = 0;
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_fast, &iter_to_colour,cx0,cy0,softdelta,N_MAX);
+   printf("Iterations: %u, %u with the interior checks\n", soft_iterations, mandelbrot_iterations);
+#ifdef __OR1300__
+   printf("cycles_per_pixel,kernel,indirect,specialized\n");
+   print_cycles_per_pixel("soft",frameBuffer,&calc_mandelbrot_point_soft,cx0,cy0,softdelta);
+   print_cycles_per_pixel("fast",frameBuffer,&calc_mandelbrot_point_fast,cx0,cy0,softdelta);
+#endif
 #ifdef OR1300   
    dcache_flush();
 #endif
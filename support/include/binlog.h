@@ -0,0 +1,142 @@
+#ifndef BINLOG_H_INCLUDED
+#define BINLOG_H_INCLUDED
+
+#include <defs.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef BINLOG_SIZE
+/// @brief Size of the log buffer, in 32-bit words.
+#define BINLOG_SIZE 4096
+#endif
+
+/**
+ * @brief Logs a message without formatting it.
+ *
+ * Stores the address of the format string followed by the raw arguments, 64-bit
+ * arguments as two words (high word first). `binlog_flush` prints the words and
+ * `support/tools/binlog.py` formats them on the host, reading the format strings
+ * from the ELF. The decoded output is the one of `printf`.
+ *
+ * The format must be a string literal. The arguments must match the format, as
+ * for `printf`: the macro turns `-Wformat` on for its own arguments, whatever the
+ * makefile flags. `%s` arguments are decoded only if they point to constant data of
+ * the ELF, e.g. string literals. Floats are not supported.
+ *
+ * @note The buffer is not shared between CPUs and must not be written concurrently
+ * by an interrupt handler and the code it interrupts.
+ *
+ */
+#define BINLOG(fmt, ...)                                                          \
+    do {                                                                          \
+        _Pragma("GCC diagnostic push")                                            \
+        _Pragma("GCC diagnostic warning \"-Wformat\"")                             \
+        if (0)                                                                    \
+            binlog_check_format(fmt, ##__VA_ARGS__);                              \
+        _Pragma("GCC diagnostic pop")                                             \
+        uint32_t* binlog_p = binlog_reserve(1 BINLOG_MAP(BINLOG_WORDS, ##__VA_ARGS__)); \
+        if (binlog_p) {                                                           \
+            *binlog_p++ = (uint32_t)("" fmt "");                                  \
+            BINLOG_MAP(BINLOG_PUT, ##__VA_ARGS__)                                 \
+        }                                                                         \
+    } while (0)
+
+struct binlog {
+    uint32_t words[BINLOG_SIZE];
+
+    /// @brief Number of words written since the last flush.
+    uint32_t used;
+
+    /// @brief Number of messages dropped because the buffer was full.
+    uint32_t dropped;
+};
+
+extern struct binlog binlog;
+
+/**
+ * @brief Prints the logged words and empties the buffer.
+ *
+ */
+void binlog_flush();
+
+/**
+ * @brief Reserves words in the buffer.
+ *
+ * @param words
+ * @return uint32_t* The reserved words, NULL if the buffer is full.
+ */
+__static_inline uint32_t* binlog_reserve(uint32_t words) {
+    if (binlog.used + words > BINLOG_SIZE) {
+        binlog.dropped++;
+        return NULL;
+    }
+
+    uint32_t* p = &binlog.words[binlog.used];
+    binlog.used += words;
+    return p;
+}
+
+__static_inline uint32_t* binlog_put32(uint32_t* p, uint32_t value) {
+    *p = value;
+    return p + 1;
+}
+
+__static_inline uint32_t* binlog_put64(uint32_t* p, uint64_t value) {
+    p[0] = (uint32_t)(value >> 32);
+    p[1] = (uint32_t)value;
+    return p + 2;
+}
+
+/**
+ * @brief Does nothing, lets the compiler check the arguments against the format.
+ *
+ */
+__attribute__((format(__printf__, 1, 2))) void binlog_check_format(const char* fmt, ...);
+
+/// @brief Words taken by an argument, preceded by `+`.
+#define BINLOG_WORDS(x) + ((sizeof(x) + 3) / 4)
+
+/// @brief An argument as stored: 64-bit integers as is, integers and pointers of any type as a word.
+#define BINLOG_ARG(x)                       \
+    _Generic((x),                           \
+        long long: (x),                     \
+        unsigned long long: (x),            \
+        default: (uint32_t)(uintptr_t)(x))
+
+/// @brief Stores an argument.
+#define BINLOG_PUT(x)                       \
+    binlog_p = _Generic((x),                \
+        long long: binlog_put64,            \
+        unsigned long long: binlog_put64,   \
+        default: binlog_put32)(binlog_p, BINLOG_ARG(x));
+
+/// @brief Applies `m` to each of the (up to 12) arguments.
+#define BINLOG_MAP(m, ...) BINLOG_MAP_N(BINLOG_COUNT(__VA_ARGS__))(m, ##__VA_ARGS__)
+#define BINLOG_MAP_N(n) BINLOG_CAT(BINLOG_MAP_, n)
+#define BINLOG_CAT(a, b) BINLOG_CAT_(a, b)
+#define BINLOG_CAT_(a, b) a##b
+#define BINLOG_COUNT(...) BINLOG_COUNT_(_, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_COUNT_(_, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, n, ...) n
+#define BINLOG_MAP_0(m)
+#define BINLOG_MAP_1(m, a) m(a)
+#define BINLOG_MAP_2(m, a, ...) m(a) BINLOG_MAP_1(m, __VA_ARGS__)
+#define BINLOG_MAP_3(m, a, ...) m(a) BINLOG_MAP_2(m, __VA_ARGS__)
+#define BINLOG_MAP_4(m, a, ...) m(a) BINLOG_MAP_3(m, __VA_ARGS__)
+#define BINLOG_MAP_5(m, a, ...) m(a) BINLOG_MAP_4(m, __VA_ARGS__)
+#define BINLOG_MAP_6(m, a, ...) m(a) BINLOG_MAP_5(m, __VA_ARGS__)
+#define BINLOG_MAP_7(m, a, ...) m(a) BINLOG_MAP_6(m, __VA_ARGS__)
+#define BINLOG_MAP_8(m, a, ...) m(a) BINLOG_MAP_7(m, __VA_ARGS__)
+#define BINLOG_MAP_9(m, a, ...) m(a) BINLOG_MAP_8(m, __VA_ARGS__)
+#define BINLOG_MAP_10(m, a, ...) m(a) BINLOG_MAP_9(m, __VA_ARGS__)
+#define BINLOG_MAP_11(m, a, ...) m(a) BINLOG_MAP_10(m, __VA_ARGS__)
+#define BINLOG_MAP_12(m, a, ...) m(a) BINLOG_MAP_11(m, __VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BINLOG_H_INCLUDED */
@@ -4,6 +4,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/**
+ * @brief Places a global variable in the .text.global section.
+ *
+ * @note Trailing `#` prevents assembler messages with mutable variables.
+ *
+ */
+#define __global __attribute__((section(".text.global # ")))
+
 /**
  * @brief Marks a function to be always inline.
  *
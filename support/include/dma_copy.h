@@ -0,0 +1,115 @@
+#ifndef DMA_COPY_H_INCLUDED
+#define DMA_COPY_H_INCLUDED
+
+#include <defs.h>
+#include <dma.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DMA_COPY_THRESHOLD
+/// @brief Size in bytes from which `dma_memcpy`/`dma_memset` use the DMA, below it the CPU is faster.
+#define DMA_COPY_THRESHOLD 2048
+#endif
+
+#ifndef DMA_STAGING_ADDRESS
+/// @brief Start of the SPM region the transfers are staged in.
+#define DMA_STAGING_ADDRESS DMA_SPM_ADDRESS
+#endif
+
+#ifndef DMA_STAGING_SIZE
+/// @brief Size in bytes of the staging region, at most `DMA_SPM_DATA_SIZE`.
+#define DMA_STAGING_SIZE DMA_SPM_DATA_SIZE
+#endif
+
+/// @brief D$ line size in bytes. The DMA only writes whole lines of the destination.
+#define DMA_COPY_LINE 32
+
+#ifndef DMA_COPY_BURST
+/// @brief Burst size field of the start register.
+#define DMA_COPY_BURST 0xFF
+#endif
+
+/**
+ * @brief Identifies an asynchronous copy or fill, see `dma_copy_done`.
+ *
+ * 0 is the token of the operations done by the CPU, which are complete on return.
+ *
+ */
+typedef uint32_t dma_copy_token;
+
+/**
+ * @brief Copies `n` bytes like `memcpy`. Large copies go through the SPM with
+ * the DMA: memory to SPM, then SPM to memory, one staging region at a time.
+ *
+ * The CPU copies the head and the tail of the destination up to `DMA_COPY_LINE`
+ * boundaries, so no line shared with neighbouring data is written back over
+ * the transferred bytes.
+ *
+ * @return void* dst
+ */
+void* dma_memcpy(void* dst, const void* src, size_t n);
+
+/**
+ * @brief Fills `n` bytes like `memset`. Large fills write the SPM once and
+ * store it repeatedly with the DMA.
+ *
+ * @return void* dst
+ */
+void* dma_memset(void* dst, int c, size_t n);
+
+/**
+ * @brief Starts `dma_memcpy` and returns before the transfers are done.
+ *
+ * Neither buffer may be accessed by the CPU until the copy is done: the data
+ * cache is flushed when the copy starts and when it completes, a line touched
+ * in between would be stale or would overwrite the transferred data.
+ *
+ * There is a single DMA: a copy started while another is in flight waits
+ * for the former to complete.
+ *
+ * @return dma_copy_token
+ */
+dma_copy_token dma_memcpy_async(void* dst, const void* src, size_t n);
+
+/**
+ * @brief Starts `dma_memset` and returns before the transfers are done, see `dma_memcpy_async`.
+ *
+ * @return dma_copy_token
+ */
+dma_copy_token dma_memset_async(void* dst, int c, size_t n);
+
+/**
+ * @brief Moves the operation in flight forward and tells if an operation is complete.
+ *
+ * The transfers are chained by the CPU: the next transfer of an operation is
+ * started by the next call to `dma_copy_done` or `dma_copy_wait` after the
+ * former one is complete, which should be polled regularly.
+ *
+ * @param token
+ * @return int 1 if the operation of `token` is complete.
+ */
+int dma_copy_done(dma_copy_token token);
+
+/**
+ * @brief Waits for the operation of `token` to complete.
+ *
+ * @param token
+ */
+void dma_copy_wait(dma_copy_token token);
+
+/**
+ * @brief Number of DMA transfers which reported an error and were redone by the CPU.
+ *
+ * @return uint32_t
+ */
+uint32_t dma_copy_errors();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_COPY_H_INCLUDED */
@@ -0,0 +1,85 @@
+#ifndef PERF_EXPORT_H_INCLUDED
+#define PERF_EXPORT_H_INCLUDED
+
+#include <defs.h>
+#include <perf.h>
+#include <perf_session.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PERF_BUILD_ID
+/// @brief Identifies the firmware version in the records.
+/// Makefiles may pass e.g. `-DPERF_BUILD_ID='"$(shell git describe --always --dirty)"'`.
+#define PERF_BUILD_ID __DATE__ " " __TIME__
+#endif
+
+enum perf_export_format {
+    /**
+     * @brief One line per value:
+     * `perf,<run>,"<build>","<name>","<config>",<key>,<value>`
+     */
+    PERF_EXPORT_CSV,
+
+    /**
+     * @brief One line per record:
+     * `{"perf":1,"run":<run>,"build":"<build>","name":"<name>","config":"<config>","values":{"<key>":<value>,...}}`
+     */
+    PERF_EXPORT_JSONL
+};
+
+/**
+ * @brief Selects the output format and the run id of the next records.
+ *
+ * @note Names, configs and keys are printed verbatim, they must not contain double quotes.
+ *
+ * @param format
+ * @param run Run id, e.g. the index of the run in a sweep.
+ */
+void perf_export_init(enum perf_export_format format, uint32_t run);
+
+/**
+ * @brief Starts a record.
+ *
+ * @param name Measured region or workload.
+ * @param config Configuration of the measurement, e.g. "cache=4way_4k,memdist=0".
+ */
+void perf_export_begin(const char* name, const char* config);
+
+/**
+ * @brief Adds a value to the current record.
+ *
+ * @param key
+ * @param value
+ */
+void perf_export_value(const char* key, uint64_t value);
+
+/**
+ * @brief Ends the current record.
+ *
+ */
+void perf_export_end();
+
+/**
+ * @brief Exports the runtime and the 8 counters, with their masks.
+ *
+ * @param name
+ * @param config
+ */
+void perf_export_counters(const char* name, const char* config);
+
+/**
+ * @brief Exports the cycles and the per-run averages of the events of a session.
+ *
+ * @param session
+ * @param name
+ * @param config
+ */
+void perf_export_session(const struct perf_session* session, const char* name, const char* config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_EXPORT_H_INCLUDED */
@@ -0,0 +1,191 @@
+#ifndef PERF_SCOPE_H_INCLUDED
+#define PERF_SCOPE_H_INCLUDED
+
+#include <defs.h>
+#include <stdint.h>
+
+#ifdef __OR1300__
+#include <perf.h>
+#include <spr.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Number of per-CPU region tables, indexed by the CPU id of SPR 9.
+#define PERF_SCOPE_CPUS 4
+
+/// @brief Maximum number of regions per CPU, the root included.
+#define PERF_SCOPE_MAX_REGIONS 32
+
+#ifndef PERF_SCOPE_COUNTER
+/// @brief Performance counter sampled by the scopes, next to the runtime cycles.
+/// The application selects the counted event (e.g. D$ misses) with `perf_set_mask`.
+#define PERF_SCOPE_COUNTER 7
+#endif
+
+/**
+ * @brief Region of the profile tree, i.e. a named scope under a given parent.
+ *
+ */
+struct perf_scope_region {
+    /** @brief Name of the scope. */
+    const char* name;
+
+    /** @brief Parent region, 0 for the root. */
+    uint16_t parent;
+
+    /** @brief Number of times the region was entered. */
+    uint32_t calls;
+
+    /** @brief Inclusive cycles. */
+    uint64_t cycles;
+
+    /** @brief Inclusive cycles of the child regions. */
+    uint64_t child_cycles;
+
+    /** @brief Inclusive `PERF_SCOPE_COUNTER` events. */
+    uint64_t events;
+
+    /** @brief Inclusive `PERF_SCOPE_COUNTER` events of the child regions. */
+    uint64_t child_events;
+};
+
+/**
+ * @brief Region table of one CPU. Only this CPU writes into it.
+ *
+ */
+struct perf_scope_table {
+    /** @brief Regions, `regions[0]` is the root. */
+    struct perf_scope_region regions[PERF_SCOPE_MAX_REGIONS];
+
+    /** @brief Number of used regions, the root included. */
+    uint16_t count;
+
+    /** @brief Innermost active region. */
+    uint16_t current;
+};
+
+/**
+ * @brief Per call site cache of the region looked up the last time, per CPU.
+ *
+ */
+struct perf_scope_site {
+    uint16_t parent[PERF_SCOPE_CPUS];
+    uint16_t region[PERF_SCOPE_CPUS];
+};
+
+/**
+ * @brief Counter values at the entry of a scope.
+ *
+ */
+struct perf_scope_frame {
+    struct perf_scope_table* table;
+    uint16_t region;
+    uint16_t parent;
+    uint32_t cycles;
+    uint32_t events;
+};
+
+extern struct perf_scope_table perf_scope_tables[PERF_SCOPE_CPUS];
+
+/**
+ * @brief Finds or creates the region `name` under `parent`.
+ *
+ * @return uint16_t Region, 0 if the table is full.
+ */
+uint16_t perf_scope_lookup(struct perf_scope_table* table, const char* name, uint16_t parent);
+
+/**
+ * @brief Resets the counts of the regions of the current CPU.
+ *
+ * @note Must not be called from inside a scope.
+ *
+ */
+void perf_scope_reset();
+
+/**
+ * @brief Prints the region tree of a CPU, children sorted by decreasing inclusive cycles.
+ *
+ * @param cpu CPU id, as read from SPR 9.
+ */
+void perf_scope_dump(unsigned cpu);
+
+#if defined(__OR1300__) && !defined(PERF_SCOPE_DISABLE)
+
+/*
+ * The low words of the counters are enough: a scope is assumed to last
+ * less than 2^32 cycles, and the differences are wrap-around safe.
+ */
+__static_inline struct perf_scope_frame perf_scope_enter(struct perf_scope_site* site, const char* name) {
+    unsigned cpu = SPR_READ(9) & 0xF;
+    struct perf_scope_table* table = &perf_scope_tables[cpu];
+    struct perf_scope_frame frame;
+
+    uint16_t parent = table->current;
+    uint16_t region = site->region[cpu];
+    if (region == 0 || site->parent[cpu] != parent) {
+        region = perf_scope_lookup(table, name, parent);
+        site->parent[cpu] = parent;
+        site->region[cpu] = region;
+    }
+
+    frame.table = table;
+    frame.region = region;
+    frame.parent = parent;
+    table->current = region;
+
+    frame.events = SPR_READ2(PERF_SPR, PERF_SCOPE_COUNTER * 2 + 11);
+    frame.cycles = SPR_READ2(PERF_SPR, PERF_COUNTER_RUNTIME * 2 + 11);
+    return frame;
+}
+
+__static_inline void perf_scope_exit(struct perf_scope_frame* frame) {
+    uint32_t cycles = SPR_READ2(PERF_SPR, PERF_COUNTER_RUNTIME * 2 + 11) - frame->cycles;
+    uint32_t events = SPR_READ2(PERF_SPR, PERF_SCOPE_COUNTER * 2 + 11) - frame->events;
+
+    struct perf_scope_table* table = frame->table;
+    table->current = frame->parent;
+    if (frame->region == 0)
+        return;
+
+    struct perf_scope_region* region = &table->regions[frame->region];
+    region->calls++;
+    region->cycles += cycles;
+    region->events += events;
+
+    struct perf_scope_region* parent = &table->regions[frame->parent];
+    parent->child_cycles += cycles;
+    parent->child_events += events;
+}
+
+#define PERF_SCOPE_CONCAT_DETAIL(a, b) a##b
+#define PERF_SCOPE_CONCAT(a, b) PERF_SCOPE_CONCAT_DETAIL(a, b)
+
+/**
+ * @brief Profiles the enclosing block from this point to its end.
+ *
+ * @example
+ * for (int k = 0; k < height; ++k) {
+ *     PERF_SCOPE("row");
+ *     ...
+ * }
+ */
+#define PERF_SCOPE(name)                                                                   \
+    static struct perf_scope_site PERF_SCOPE_CONCAT(perf_scope_site_, __LINE__);           \
+    struct perf_scope_frame PERF_SCOPE_CONCAT(perf_scope_frame_, __LINE__)                 \
+        __attribute__((cleanup(perf_scope_exit))) =                                        \
+            perf_scope_enter(&PERF_SCOPE_CONCAT(perf_scope_site_, __LINE__), (name))
+
+#else
+
+#define PERF_SCOPE(name) ((void)(name))
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_SCOPE_H_INCLUDED */
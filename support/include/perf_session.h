@@ -0,0 +1,153 @@
+#ifndef PERF_SESSION_H_INCLUDED
+#define PERF_SESSION_H_INCLUDED
+
+#include <defs.h>
+#include <perf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Number of hardware counters that can be programmed at once.
+#define PERF_SESSION_COUNTERS 8
+
+/// @brief Maximum number of events in a session.
+#define PERF_SESSION_MAX_EVENTS 32
+
+/**
+ * @brief Set of named events measured over one or several runs of a region.
+ *
+ * @note When more than `PERF_SESSION_COUNTERS` events are requested, the events
+ * are split in groups, one group is programmed per run, and the results are
+ * merged as per-run averages.
+ *
+ */
+struct perf_session {
+    /** @brief Event names. */
+    const char* names[PERF_SESSION_MAX_EVENTS];
+
+    /** @brief Event masks, see `PERF_*_MASK`. */
+    uint32_t masks[PERF_SESSION_MAX_EVENTS];
+
+    /** @brief Sum of the event counts over the runs where the event was programmed. */
+    uint64_t totals[PERF_SESSION_MAX_EVENTS];
+
+    /** @brief Number of runs where the event was programmed. */
+    uint32_t runs[PERF_SESSION_MAX_EVENTS];
+
+    /** @brief Number of events. */
+    unsigned count;
+
+    /** @brief Group programmed by the next `perf_session_begin`. */
+    unsigned group;
+
+    /** @brief Sum of the runtime cycles over all runs. */
+    uint64_t cycles;
+
+    /** @brief Number of completed runs. */
+    uint32_t total_runs;
+
+    /** @brief Counter values at `perf_session_begin`. */
+    perf_cycles_t start[PERF_SESSION_COUNTERS + 1];
+};
+
+/**
+ * @brief Initializes an empty session.
+ *
+ * @param session
+ */
+void perf_session_init(struct perf_session* session);
+
+/**
+ * @brief Adds a built-in event by name, e.g. "dcache_miss" or "stall_cycles".
+ *
+ * @param session
+ * @param name Event name, see `perf_session_list`.
+ * @return int 0 on success, -1 if the name is unknown or the session is full.
+ */
+int perf_session_add(struct perf_session* session, const char* name);
+
+/**
+ * @brief Adds a custom event counting the union of several masks.
+ *
+ * @param session
+ * @param name Event name, used when printing.
+ * @param mask Union of `PERF_*_MASK`.
+ * @return int 0 on success, -1 if the session is full.
+ */
+int perf_session_add_mask(struct perf_session* session, const char* name, uint32_t mask);
+
+/**
+ * @brief Number of runs of the region needed to measure every event once.
+ *
+ * @param session
+ * @return unsigned
+ */
+unsigned perf_session_groups(const struct perf_session* session);
+
+/**
+ * @brief Programs the counters with the next group of events and starts counting.
+ *
+ * @param session
+ */
+void perf_session_begin(struct perf_session* session);
+
+/**
+ * @brief Stops counting and accumulates the counts of the current group.
+ *
+ * @param session
+ */
+void perf_session_end(struct perf_session* session);
+
+/**
+ * @brief Average count of an event per run.
+ *
+ * @param session
+ * @param name Event name.
+ * @return uint64_t 0 if the event is unknown or was never measured.
+ */
+uint64_t perf_session_get(const struct perf_session* session, const char* name);
+
+/**
+ * @brief Average runtime cycles per run.
+ *
+ * @param session
+ * @return uint64_t
+ */
+uint64_t perf_session_cycles(const struct perf_session* session);
+
+/**
+ * @brief Prints the per-run event counts and the derived metrics
+ * (IPC, I$ and D$ miss rates, stall fraction) whose inputs were measured.
+ *
+ * @param session
+ * @param desc Description printed in the header.
+ */
+void perf_session_print(const struct perf_session* session, const char* desc);
+
+/**
+ * @brief Prints the names of the built-in events.
+ *
+ */
+void perf_session_list();
+
+/**
+ * @brief Runs a statement once per group of events of a session.
+ *
+ * @example
+ * PERF_SESSION_RUN(&session) {
+ *     draw_fractal(...);
+ * }
+ */
+#define PERF_SESSION_RUN(session)                                          \
+    for (unsigned perf_session_run_ = (perf_session_begin(session), 0);    \
+         perf_session_run_ < perf_session_groups(session);                 \
+         perf_session_end(session), perf_session_run_++,                    \
+                  (perf_session_run_ < perf_session_groups(session)         \
+                       ? perf_session_begin(session) : (void)0))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_SESSION_H_INCLUDED */
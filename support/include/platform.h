@@ -7,8 +7,61 @@ extern "C" {
 
 #define UART_BASE 0x50000000
 
+#ifndef STDOUT_BUFFER_SIZE
+/// @brief Size of the stdout buffer, in characters.
+#define STDOUT_BUFFER_SIZE 256
+#endif
+
+enum stdout_mode {
+    /** @brief Every character is written immediately (default). */
+    STDOUT_UNBUFFERED,
+
+    /** @brief The buffer is flushed on each new line and when it is full. */
+    STDOUT_LINE_BUFFERED,
+
+    /** @brief The buffer is flushed when it is full or by `stdout_flush`. */
+    STDOUT_FULLY_BUFFERED
+};
+
 void platform_init();
 
+/**
+ * @brief Writes the buffered characters to the UART and to the VGA text mirror.
+ *
+ */
+void stdout_flush();
+
+/**
+ * @brief Selects when the output is written. Flushes the buffer.
+ *
+ * @note The buffer is shared by the CPUs and not locked: select a buffered mode only
+ * in a program printing from a single CPU, and not from exception handlers.
+ * crt0 flushes it when `main` returns.
+ *
+ * @param mode
+ */
+void stdout_set_mode(enum stdout_mode mode);
+
+/**
+ * @brief Enables or disables the copy of the output to the VGA text console
+ * (enabled by default). Flushes the buffer.
+ *
+ * @param enable
+ */
+void stdout_vga_mirror(int enable);
+
+/**
+ * @brief Measures the cycles taken by some output with each stdout configuration
+ * and prints them as `stdout,<name>,<mode>,<vga>,<cycles>` lines.
+ * Restores the mode and the VGA mirror in use.
+ *
+ * @note Uses the runtime counter: call it once the measurements of the program are printed.
+ *
+ * @param name
+ * @param output Function printing the output, called once per configuration.
+ */
+void stdout_benchmark(const char* name, void (*output)());
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,7 @@ void* memcpy(void* dest, const void* src, size_t n);
 void* memmove(void* s1, const void* s2, size_t n);
 void bcopy(const void* s1, void* s2, size_t n);
 void* memset(void* dest, register int val, register size_t len);
+int strcmp(const char* s1, const char* s2);
 
 #ifdef __cplusplus
 }
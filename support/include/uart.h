@@ -37,9 +37,21 @@ extern "C" {
 #define UART_SPEED_115200_LO 0x1B
 #define UART_SPEED_115200_HI 0
 
+#define UART_FIFO_CONTROL_REGISTER 2
+#define UART_FC_ENABLE 1
+#define UART_FC_CLEAR_RX 2
+#define UART_FC_CLEAR_TX 4
+
 #define UART_TX_EMPTY_MASK 0x40
 #define UART_RX_AVAILABLE_MASK 0x01
 
+#ifndef UART_TX_BURST
+/// @brief Characters written by `uart_write` after each wait for the transmitter
+/// to be empty. Values above 1 enable the 16-byte TX FIFO of the 16550 in `uart_init`,
+/// 1 writes a character per wait as `uart_putc`. The FIFO is not verified on the board yet.
+#define UART_TX_BURST 1
+#endif
+
 // TODO make uart_init more flexible
 
 void uart_init(volatile char* uart);
@@ -47,6 +59,7 @@ void uart_wait_rx(volatile char* uart);
 void uart_wait_tx(volatile char* uart);
 void uart_putc(volatile char* uart, int c);
 void uart_puts(volatile char* uart, const char* str);
+void uart_write(volatile char* uart, const char* buf, unsigned len);
 int uart_getc(volatile char* uart);
 
 #ifdef __cplusplus
@@ -1,9 +1,11 @@
 #include <assert.h>
+#include <platform.h>
 #include <stdio.h>
 
 int (*assert_printf)(const char*, ...) = &printf_;
 
 void assert_die() {
     puts("dead!");
+    stdout_flush();
     while (1);
 }
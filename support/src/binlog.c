@@ -0,0 +1,24 @@
+#include <binlog.h>
+#include <stdio.h>
+
+/// @brief Words per line of `binlog_flush`.
+#define BINLOG_LINE_WORDS 8
+
+struct binlog binlog;
+
+void binlog_flush() {
+    printf("binlog,words=%u,dropped=%u\n", binlog.used, binlog.dropped);
+
+    for (uint32_t i = 0; i < binlog.used; i++)
+        printf(i % BINLOG_LINE_WORDS == BINLOG_LINE_WORDS - 1 || i == binlog.used - 1 ? "%08X\n" : "%08X ",
+               binlog.words[i]);
+
+    printf("binlog_end\n");
+
+    binlog.used = 0;
+    binlog.dropped = 0;
+}
+
+void binlog_check_format(const char* fmt, ...) {
+    (void)fmt;
+}
@@ -50,6 +50,8 @@ _start:
     l.xor       r3,r0,r0
     l.jal       main
     l.xor       r4,r0,r0
+    l.jal       stdout_flush
+    l.nop
 _loop_end:
     l.j         _loop_end
     l.nop
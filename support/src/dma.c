@@ -0,0 +1,114 @@
+#include <dma.h>
+#include <swap.h>
+
+static struct {
+    /** @brief Transfer programmed in the DMA, NULL if the DMA is free. */
+    struct dma_desc* active;
+
+    /** @brief First and last queued transfers. */
+    struct dma_desc* head;
+    struct dma_desc* tail;
+
+    uint32_t transfers;
+    uint32_t failures;
+} dma;
+
+static void dma_start(struct dma_desc* desc) {
+    volatile uint32_t* regs = (volatile uint32_t*)DMA_BASE_ADDRESS;
+    uint32_t burst = desc->burst ? desc->burst : DMA_DEFAULT_BURST;
+
+    desc->state = DMA_DESC_ACTIVE;
+    dma.active = desc;
+
+    regs[MEMORY_ADDRESS_ID] = swap_u32((uint32_t)desc->mem);
+    regs[SPM_ADDRESS_ID] = swap_u32(desc->spm);
+    regs[TRANSFER_SIZE_ID] = swap_u32(desc->words);
+    regs[START_STATUS_ID] = swap_u32(desc->direction | (burst & DMA_BURST_MASK));
+}
+
+/**
+ * @brief Starts the first queued transfer.
+ *
+ */
+static void dma_start_next() {
+    struct dma_desc* desc = dma.head;
+    if (!desc)
+        return;
+
+    dma.head = desc->next;
+    if (!dma.head)
+        dma.tail = NULL;
+    desc->next = NULL;
+
+    dma_start(desc);
+}
+
+void dma_submit(struct dma_desc* desc) {
+    desc->state = DMA_DESC_QUEUED;
+    desc->errors = 0;
+    desc->next = NULL;
+
+    if (dma.tail)
+        dma.tail->next = desc;
+    else
+        dma.head = desc;
+    dma.tail = desc;
+
+    /* a done transfer is completed by the next `dma_poll`, not here: `on_done` may submit */
+    if (!dma.active)
+        dma_start_next();
+}
+
+int dma_poll(struct dma_desc* desc) {
+    struct dma_desc* done = dma.active;
+
+    if (done) {
+        volatile uint32_t* regs = (volatile uint32_t*)DMA_BASE_ADDRESS;
+        uint32_t status = swap_u32(regs[START_STATUS_ID]);
+
+        if (status & DMA_BUSY_BIT) {
+            done = NULL;
+        } else {
+            dma.active = NULL;
+            dma.transfers++;
+            dma.failures += (status & DMA_ERROR_MASK) != 0;
+
+            done->errors = status & DMA_ERROR_MASK;
+            done->state = DMA_DESC_DONE;
+        }
+    }
+
+    /* chains the next transfer before running the callback */
+    if (!dma.active)
+        dma_start_next();
+
+    if (done && done->on_done)
+        done->on_done(done);
+
+    if (desc)
+        return desc->state == DMA_DESC_DONE || desc->state == DMA_DESC_IDLE;
+    return !dma.active && !dma.head;
+}
+
+uint32_t dma_wait(struct dma_desc* desc) {
+    while (!dma_poll(desc))
+        ;
+    return desc ? desc->errors : 0;
+}
+
+const char* dma_error_string(uint32_t errors) {
+    if (errors & DMA_MEM_ALLIGN_ERROR_BIT)
+        return "memory address not word-aligned";
+    if (errors & DMA_SPM_ALLIGN_ERROR_BIT)
+        return "SPM address not word-aligned";
+    if (errors & DMA_SPM_OUT_OF_RANGE_ERROR_BIT)
+        return "SPM range out of bounds";
+    if (errors & DMA_ERROR_BIT)
+        return "transfer error";
+    return "none";
+}
+
+void dma_stats(uint32_t* transfers, uint32_t* failures) {
+    *transfers = dma.transfers;
+    *failures = dma.failures;
+}
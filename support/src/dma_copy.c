@@ -0,0 +1,202 @@
+#include <cache.h>
+#include <dma.h>
+#include <dma_copy.h>
+#include <string.h>
+
+enum dma_copy_phase {
+    DMA_COPY_IDLE,
+    /** @brief Memory to SPM transfer of the current chunk in flight. */
+    DMA_COPY_LOAD,
+    /** @brief SPM to memory transfer of the current chunk in flight. */
+    DMA_COPY_STORE,
+};
+
+/**
+ * @brief Operation in flight, the DMA is not shared between CPUs.
+ *
+ */
+static struct {
+    enum dma_copy_phase phase;
+
+    /** @brief Transfer of the current chunk. */
+    struct dma_desc desc;
+
+    /** @brief Token of the operation in flight. */
+    dma_copy_token token;
+
+    /** @brief Last completed token. */
+    dma_copy_token completed;
+
+    /** @brief Remaining destination, aligned on a D$ line. */
+    uint8_t* dst;
+
+    /** @brief Remaining source, NULL for a fill. */
+    const uint8_t* src;
+
+    /** @brief Remaining bytes, a multiple of `DMA_COPY_LINE`. */
+    size_t remaining;
+
+    /** @brief Bytes of the current chunk. */
+    size_t chunk;
+
+    /** @brief Pattern of a fill. */
+    uint8_t value;
+
+    uint32_t errors;
+} dma_copy;
+
+static void dma_copy_on_done(struct dma_desc* desc);
+
+static void dma_copy_submit(enum dma_copy_phase phase, const void* mem, uint32_t direction) {
+    dma_copy.phase = phase;
+    dma_desc_init(&dma_copy.desc, (void*)mem, DMA_STAGING_ADDRESS, dma_copy.chunk >> 2, direction);
+    dma_copy.desc.burst = DMA_COPY_BURST;
+    dma_copy.desc.on_done = &dma_copy_on_done;
+    dma_submit(&dma_copy.desc);
+}
+
+static void dma_copy_next_chunk() {
+    dma_copy.chunk = dma_copy.remaining < DMA_STAGING_SIZE ? dma_copy.remaining : DMA_STAGING_SIZE;
+
+    if (dma_copy.src)
+        dma_copy_submit(DMA_COPY_LOAD, dma_copy.src, DMA_FROM_MEM_TO_SPM);
+    else
+        dma_copy_submit(DMA_COPY_STORE, dma_copy.dst, DMA_FROM_SPM_TO_MEM);
+}
+
+/**
+ * @brief Starts the transfers of the line-aligned part of an operation.
+ *
+ * The CPU is done with the head and the tail, the lines the transferred bytes
+ * share with other data: the flush writes them back, and the transfers only
+ * cover whole lines, which nothing else dirties until the completion flush.
+ *
+ */
+static dma_copy_token dma_copy_start(uint8_t* dst, const uint8_t* src, size_t n) {
+    dcache_flush();
+
+    dma_copy.token++;
+    dma_copy.dst = dst;
+    dma_copy.src = src;
+    dma_copy.remaining = n;
+    dma_copy_next_chunk();
+    return dma_copy.token;
+}
+
+/**
+ * @brief Completes a chunk whose transfer failed with the CPU.
+ *
+ */
+static void dma_copy_fallback() {
+    dma_copy.errors++;
+
+    if (dma_copy.src)
+        memcpy(dma_copy.dst, dma_copy.src, dma_copy.chunk);
+    else
+        memset(dma_copy.dst, dma_copy.value, dma_copy.chunk);
+}
+
+/**
+ * @brief Chains the next transfer of the operation, called by the driver.
+ *
+ */
+static void dma_copy_on_done(struct dma_desc* desc) {
+    if (desc->errors) {
+        dma_copy_fallback();
+    } else if (dma_copy.phase == DMA_COPY_LOAD) {
+        dma_copy_submit(DMA_COPY_STORE, dma_copy.dst, DMA_FROM_SPM_TO_MEM);
+        return;
+    }
+
+    dma_copy.dst += dma_copy.chunk;
+    if (dma_copy.src)
+        dma_copy.src += dma_copy.chunk;
+    dma_copy.remaining -= dma_copy.chunk;
+
+    if (dma_copy.remaining) {
+        dma_copy_next_chunk();
+        return;
+    }
+
+    /* drops the lines of the destination cached before the transfers */
+    dcache_flush();
+    dma_copy.phase = DMA_COPY_IDLE;
+    dma_copy.completed = dma_copy.token;
+}
+
+int dma_copy_done(dma_copy_token token) {
+    dma_poll(NULL);
+    return (int32_t)(dma_copy.completed - token) >= 0;
+}
+
+void dma_copy_wait(dma_copy_token token) {
+    while (!dma_copy_done(token))
+        ;
+}
+
+uint32_t dma_copy_errors() {
+    return dma_copy.errors;
+}
+
+dma_copy_token dma_memcpy_async(void* dst, const void* src, size_t n) {
+    uint8_t* d = dst;
+    const uint8_t* s = src;
+
+    /*
+     * the DMA moves words, both buffers must be aligned the same way, and at
+     * least one whole line of the destination must be left after its head
+     */
+    if (n < DMA_COPY_THRESHOLD || n < 2 * DMA_COPY_LINE || (((uintptr_t)d ^ (uintptr_t)s) & 3)) {
+        memcpy(dst, src, n);
+        return 0;
+    }
+
+    dma_copy_wait(dma_copy.token);
+
+    size_t head = -(uintptr_t)d & (DMA_COPY_LINE - 1);
+    size_t tail = (n - head) & (DMA_COPY_LINE - 1);
+    size_t words = n - head - tail;
+
+    memcpy(d, s, head);
+    memcpy(d + head + words, s + head + words, tail);
+    return dma_copy_start(d + head, s + head, words);
+}
+
+dma_copy_token dma_memset_async(void* dst, int c, size_t n) {
+    uint8_t* d = dst;
+
+    /* at least one whole line after the head */
+    if (n < DMA_COPY_THRESHOLD || n < 2 * DMA_COPY_LINE) {
+        memset(dst, c, n);
+        return 0;
+    }
+
+    dma_copy_wait(dma_copy.token);
+
+    size_t head = -(uintptr_t)d & (DMA_COPY_LINE - 1);
+    size_t tail = (n - head) & (DMA_COPY_LINE - 1);
+    size_t words = n - head - tail;
+
+    memset(d, c, head);
+    memset(d + head + words, c, tail);
+
+    /* the staging region is written once and stored repeatedly */
+    uint32_t pattern = (uint8_t)c * 0x01010101u;
+    volatile uint32_t* spm = (volatile uint32_t*)DMA_STAGING_ADDRESS;
+    size_t fill = words < DMA_STAGING_SIZE ? words : DMA_STAGING_SIZE;
+    for (size_t i = 0; i < fill / 4; i++)
+        spm[i] = pattern;
+
+    dma_copy.value = c;
+    return dma_copy_start(d + head, NULL, words);
+}
+
+void* dma_memcpy(void* dst, const void* src, size_t n) {
+    dma_copy_wait(dma_memcpy_async(dst, src, n));
+    return dst;
+}
+
+void* dma_memset(void* dst, int c, size_t n) {
+    dma_copy_wait(dma_memset_async(dst, c, n));
+    return dst;
+}
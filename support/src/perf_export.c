@@ -0,0 +1,65 @@
+#include <perf_export.h>
+#include <stdio.h>
+
+static struct {
+    enum perf_export_format format;
+    uint32_t run;
+
+    /** @brief Current record. */
+    const char* name;
+    const char* config;
+    unsigned values;
+} perf_export = { .format = PERF_EXPORT_CSV };
+
+void perf_export_init(enum perf_export_format format, uint32_t run) {
+    perf_export.format = format;
+    perf_export.run = run;
+}
+
+void perf_export_begin(const char* name, const char* config) {
+    perf_export.name = name ? name : "";
+    perf_export.config = config ? config : "";
+    perf_export.values = 0;
+
+    if (perf_export.format == PERF_EXPORT_JSONL)
+        printf("{\"perf\":1,\"run\":%u,\"build\":\"%s\",\"name\":\"%s\",\"config\":\"%s\",\"values\":{",
+               perf_export.run, PERF_BUILD_ID, perf_export.name, perf_export.config);
+}
+
+void perf_export_value(const char* key, uint64_t value) {
+    if (perf_export.format == PERF_EXPORT_JSONL)
+        printf("%s\"%s\":%llu", perf_export.values ? "," : "", key, value);
+    else
+        printf("perf,%u,\"%s\",\"%s\",\"%s\",%s,%llu\n",
+               perf_export.run, PERF_BUILD_ID, perf_export.name, perf_export.config, key, value);
+
+    perf_export.values++;
+}
+
+void perf_export_end() {
+    if (perf_export.format == PERF_EXPORT_JSONL)
+        printf("}}\n");
+}
+
+void perf_export_counters(const char* name, const char* config) {
+    char key[16];
+
+    perf_export_begin(name, config);
+    perf_export_value("cycles", perf_read_counter(PERF_COUNTER_RUNTIME));
+    for (unsigned c = 0; c < PERF_COUNTER_RUNTIME; c++) {
+        snprintf(key, sizeof(key), "counter%u", c);
+        perf_export_value(key, perf_read_counter(c));
+        snprintf(key, sizeof(key), "mask%u", c);
+        perf_export_value(key, perf_get_mask(c));
+    }
+    perf_export_end();
+}
+
+void perf_export_session(const struct perf_session* session, const char* name, const char* config) {
+    perf_export_begin(name, config);
+    perf_export_value("cycles", perf_session_cycles(session));
+    perf_export_value("runs", session->total_runs);
+    for (unsigned e = 0; e < session->count; e++)
+        perf_export_value(session->names[e], perf_session_get(session, session->names[e]));
+    perf_export_end();
+}
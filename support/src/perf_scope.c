@@ -0,0 +1,79 @@
+#include <perf_scope.h>
+#include <spr.h>
+#include <stdio.h>
+#include <string.h>
+
+__global struct perf_scope_table perf_scope_tables[PERF_SCOPE_CPUS];
+
+uint16_t perf_scope_lookup(struct perf_scope_table* table, const char* name, uint16_t parent) {
+    if (table->count == 0)
+        table->count = 1; // root
+
+    for (uint16_t i = 1; i < table->count; i++) {
+        struct perf_scope_region* region = &table->regions[i];
+        if (region->parent == parent && (region->name == name || strcmp(region->name, name) == 0))
+            return i;
+    }
+
+    if (table->count == PERF_SCOPE_MAX_REGIONS)
+        return 0;
+
+    uint16_t i = table->count++;
+    memset(&table->regions[i], 0, sizeof(table->regions[i]));
+    table->regions[i].name = name;
+    table->regions[i].parent = parent;
+    return i;
+}
+
+void perf_scope_reset() {
+    struct perf_scope_table* table = &perf_scope_tables[SPR_READ(9) & 0xF];
+
+    // the regions are kept, the call sites cache their indices
+    for (uint16_t i = 0; i < table->count; i++) {
+        struct perf_scope_region* region = &table->regions[i];
+        region->calls = 0;
+        region->cycles = 0;
+        region->child_cycles = 0;
+        region->events = 0;
+        region->child_events = 0;
+    }
+}
+
+static void dump_children(const struct perf_scope_table* table, uint16_t parent, unsigned depth) {
+    uint16_t children[PERF_SCOPE_MAX_REGIONS];
+    unsigned count = 0;
+
+    // insertion sort by decreasing inclusive cycles
+    for (uint16_t i = 1; i < table->count; i++) {
+        if (table->regions[i].parent != parent)
+            continue;
+
+        unsigned j = count++;
+        while (j > 0 && table->regions[children[j - 1]].cycles < table->regions[i].cycles) {
+            children[j] = children[j - 1];
+            j--;
+        }
+        children[j] = i;
+    }
+
+    for (unsigned c = 0; c < count; c++) {
+        const struct perf_scope_region* region = &table->regions[children[c]];
+
+        unsigned indent = depth < 12 ? 2 * depth : 24;
+        printf("%*s%-*s %8u %12llu %12llu %10llu %10llu\n",
+               indent, "", 24 - indent, region->name, region->calls,
+               region->cycles, region->cycles - region->child_cycles,
+               region->events, region->events - region->child_events);
+
+        dump_children(table, children[c], depth + 1);
+    }
+}
+
+void perf_scope_dump(unsigned cpu) {
+    const struct perf_scope_table* table = &perf_scope_tables[cpu];
+
+    printf("Profile of CPU %u\n", cpu);
+    printf("%-24s %8s %12s %12s %10s %10s\n",
+           "region", "calls", "incl cycles", "excl cycles", "incl events", "excl events");
+    dump_children(table, 0, 0);
+}
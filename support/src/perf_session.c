@@ -0,0 +1,158 @@
+#include <perf_session.h>
+#include <stdio.h>
+#include <string.h>
+
+static const struct {
+    const char* name;
+    uint32_t mask;
+} perf_events[] = {
+    { "instruction_fetch", PERF_INSTRUCTION_FETCH_MASK },
+    { "icache_miss", PERF_ICACHE_MISS_MASK },
+    { "icache_miss_penalty", PERF_ICACHE_MISS_PENALY_MASK },
+    { "icache_flush_penalty", PERF_ICACHE_FLUSH_PENALTY_MASH },
+    { "icache_nop_insertion", PERF_ICACHE_NOP_INSERTION_MASK },
+    { "branch_penalty", PERF_BRANCH_PENALTY_MASK },
+    { "executed_instructions", PERF_EXECUTED_INSTRUCTIONS_MASK },
+    { "stall_cycles", PERF_STALL_CYCLES_MASK },
+    { "bus_idle", PERF_BUS_IDLE_MASK },
+    { "dcache_uncache_write", PERF_DCACHE_UNCACHE_WRITE_MASK },
+    { "dcache_uncache_read", PERF_DCACHE_UNCACHE_READ_MASK },
+    { "dcache_cache_write", PERF_DCACHE_CACHE_WRITE_MASK },
+    { "dcache_cache_read", PERF_DCACHE_CACHE_READ_MASK },
+    { "dcache_swap", PERF_DCACHE_SWAP_MASK },
+    { "dcache_cas", PERF_DCACHE_CAS_MASK },
+    { "dcache_miss", PERF_DCACHE_MISS_MASK },
+    { "dcache_write_back", PERF_DCACHE_WRITE_BACK_MASK },
+    { "dcache_data_dep", PERF_DCACHE_DATA_DEP_MASK },
+    { "dcache_write_dep", PERF_DCACHE_WRITE_DEP_MASK },
+    { "dcache_pipe_stall", PERF_DCACHE_PIPE_STALL_MASK },
+    { "dcache_internal_stall", PERF_DCACHE_INTENAL_STALL_MASK },
+    { "dcache_write_through", PERF_DCACHE_WRITE_THROUGH_MASK },
+    { "dcache_snoopy_inval", PERF_DCACHE_SNOOPY_INVAL_MASK },
+};
+
+#define PERF_EVENT_COUNT (sizeof(perf_events) / sizeof(perf_events[0]))
+
+static int find(const struct perf_session* session, const char* name) {
+    for (unsigned i = 0; i < session->count; i++)
+        if (strcmp(session->names[i], name) == 0)
+            return i;
+    return -1;
+}
+
+void perf_session_init(struct perf_session* session) {
+    memset(session, 0, sizeof(*session));
+}
+
+int perf_session_add(struct perf_session* session, const char* name) {
+    for (unsigned i = 0; i < PERF_EVENT_COUNT; i++)
+        if (strcmp(perf_events[i].name, name) == 0)
+            return perf_session_add_mask(session, perf_events[i].name, perf_events[i].mask);
+    return -1;
+}
+
+int perf_session_add_mask(struct perf_session* session, const char* name, uint32_t mask) {
+    if (session->count == PERF_SESSION_MAX_EVENTS)
+        return -1;
+
+    session->names[session->count] = name;
+    session->masks[session->count] = mask;
+    session->count++;
+    return 0;
+}
+
+unsigned perf_session_groups(const struct perf_session* session) {
+    unsigned groups = (session->count + PERF_SESSION_COUNTERS - 1) / PERF_SESSION_COUNTERS;
+    return groups ? groups : 1;
+}
+
+void perf_session_begin(struct perf_session* session) {
+    unsigned first = session->group * PERF_SESSION_COUNTERS;
+
+    perf_stop();
+    for (unsigned c = 0; c < PERF_SESSION_COUNTERS; c++) {
+        unsigned e = first + c;
+        perf_set_mask(c, e < session->count ? session->masks[e] : 0);
+    }
+
+    for (unsigned c = 0; c <= PERF_SESSION_COUNTERS; c++)
+        session->start[c] = perf_read_counter(c);
+
+    perf_start();
+}
+
+void perf_session_end(struct perf_session* session) {
+    perf_stop();
+
+    unsigned first = session->group * PERF_SESSION_COUNTERS;
+    for (unsigned c = 0; c < PERF_SESSION_COUNTERS; c++) {
+        unsigned e = first + c;
+        if (e >= session->count)
+            break;
+        session->totals[e] += perf_read_counter(c) - session->start[c];
+        session->runs[e]++;
+    }
+
+    session->cycles += perf_read_counter(PERF_COUNTER_RUNTIME) - session->start[PERF_COUNTER_RUNTIME];
+    session->total_runs++;
+    session->group = (session->group + 1) % perf_session_groups(session);
+}
+
+static uint64_t average(const struct perf_session* session, int e) {
+    if (e < 0 || session->runs[e] == 0)
+        return 0;
+    return session->totals[e] / session->runs[e];
+}
+
+uint64_t perf_session_get(const struct perf_session* session, const char* name) {
+    return average(session, find(session, name));
+}
+
+uint64_t perf_session_cycles(const struct perf_session* session) {
+    return session->total_runs ? session->cycles / session->total_runs : 0;
+}
+
+/**
+ * @brief Prints `num / den` with three decimals.
+ *
+ */
+static void print_ratio(const char* desc, uint64_t num, uint64_t den, uint64_t scale) {
+    if (den == 0)
+        return;
+    uint64_t r = num * 1000 * scale / den;
+    printf("  %-32s : %llu.%03llu\n", desc, r / 1000, r % 1000);
+}
+
+void perf_session_print(const struct perf_session* session, const char* desc) {
+    uint64_t cycles = perf_session_cycles(session);
+
+    printf("%s (%u runs, %u groups)\n", desc ? desc : "no desc", session->total_runs, perf_session_groups(session));
+    printf("  %-32s : %llu\n", "cycles", cycles);
+    for (unsigned e = 0; e < session->count; e++)
+        printf("  %-32s : %llu\n", session->names[e], average(session, e));
+
+    int instructions = find(session, "executed_instructions");
+    int fetches = find(session, "instruction_fetch");
+    int icache_misses = find(session, "icache_miss");
+    int dcache_misses = find(session, "dcache_miss");
+    int dcache_reads = find(session, "dcache_cache_read");
+    int dcache_writes = find(session, "dcache_cache_write");
+    int stalls = find(session, "stall_cycles");
+
+    if (instructions >= 0)
+        print_ratio("IPC", average(session, instructions), cycles, 1);
+    if (fetches >= 0 && icache_misses >= 0)
+        print_ratio("I$ miss rate (%)", average(session, icache_misses), average(session, fetches), 100);
+    if (dcache_misses >= 0 && dcache_reads >= 0 && dcache_writes >= 0)
+        print_ratio(
+            "D$ miss rate (%)", average(session, dcache_misses),
+            average(session, dcache_reads) + average(session, dcache_writes), 100
+        );
+    if (stalls >= 0)
+        print_ratio("stall fraction (%)", average(session, stalls), cycles, 100);
+}
+
+void perf_session_list() {
+    for (unsigned i = 0; i < PERF_EVENT_COUNT; i++)
+        printf("%s\n", perf_events[i].name);
+}
@@ -1,15 +1,47 @@
+#include <perf.h>
 #include <platform.h>
 #include <uart.h>
 #include <vga.h>
 #include <stdio.h>
 
+static struct {
+    char buffer[STDOUT_BUFFER_SIZE];
+    unsigned len;
+    enum stdout_mode mode;
+    int vga;
+} stdout_state = { .mode = STDOUT_UNBUFFERED, .vga = 1 };
+
 void platform_init() {
     uart_init((volatile char*)UART_BASE);
 }
 
+void stdout_flush() {
+    uart_write((volatile char*)UART_BASE, stdout_state.buffer, stdout_state.len);
+
+    if (stdout_state.vga)
+        for (unsigned i = 0; i < stdout_state.len; i++)
+            vga_putc(stdout_state.buffer[i]);
+
+    stdout_state.len = 0;
+}
+
+void stdout_set_mode(enum stdout_mode mode) {
+    stdout_flush();
+    stdout_state.mode = mode;
+}
+
+void stdout_vga_mirror(int enable) {
+    stdout_flush();
+    stdout_state.vga = enable;
+}
+
 void _putchar(char c) {
-    uart_putc((volatile char*)UART_BASE, c);
-    vga_putc(c);
+    stdout_state.buffer[stdout_state.len++] = c;
+
+    if (stdout_state.len == STDOUT_BUFFER_SIZE
+        || stdout_state.mode == STDOUT_UNBUFFERED
+        || (c == '\n' && stdout_state.mode == STDOUT_LINE_BUFFERED))
+        stdout_flush();
 }
 
 int putchar(int c) {
@@ -18,14 +50,48 @@ int putchar(int c) {
 }
 
 int puts(const char *s) {
-    uart_puts((volatile char*)UART_BASE, s);
-    uart_putc((volatile char*)UART_BASE, (int) '\n');
-
-    vga_puts(s);
-    vga_putc((int)'\n');
+    while (*s)
+        _putchar(*s++);
+    _putchar('\n');
     return 0;
 }
 
 int getchar(void) {
+    stdout_flush();
     return uart_getc((volatile char*)UART_BASE);
 }
+
+void stdout_benchmark(const char* name, void (*output)()) {
+    static const struct {
+        enum stdout_mode mode;
+        int vga;
+    } configs[] = {
+        { STDOUT_UNBUFFERED, 1 },
+        { STDOUT_LINE_BUFFERED, 1 },
+        { STDOUT_LINE_BUFFERED, 0 },
+        { STDOUT_FULLY_BUFFERED, 0 },
+    };
+    static const char* modes[] = { "unbuffered", "line", "full" };
+    const unsigned count = sizeof(configs) / sizeof(configs[0]);
+    perf_cycles_t cycles[sizeof(configs) / sizeof(configs[0])];
+    enum stdout_mode mode = stdout_state.mode;
+    int vga = stdout_state.vga;
+
+    for (unsigned i = 0; i < count; i++) {
+        stdout_set_mode(configs[i].mode);
+        stdout_vga_mirror(configs[i].vga);
+
+        perf_cycles_t start = perf_read_counter(PERF_COUNTER_RUNTIME);
+        perf_start();
+        output();
+        stdout_flush();
+        perf_stop();
+        cycles[i] = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+    }
+
+    stdout_set_mode(mode);
+    stdout_vga_mirror(vga);
+
+    for (unsigned i = 0; i < count; i++)
+        printf("stdout,%s,%s,%d,%llu\n", name, modes[configs[i].mode], configs[i].vga, cycles[i]);
+}
@@ -0,0 +1,93 @@
+#include <exception.h>
+#include <profiler.h>
+#include <spr.h>
+#include <stdio.h>
+#include <tickTimer.h>
+
+#ifdef __OR1300__
+
+_Static_assert((PROFILER_BUFFER_SIZE & (PROFILER_BUFFER_SIZE - 1)) == 0, "PROFILER_BUFFER_SIZE must be a power of two");
+
+__global static struct profiler_histogram histograms[PROFILER_CPUS];
+
+/** @brief Tick timer vector of CPU 1 before `profiler_start`, restored by `profiler_stop`. */
+static exception_handler_t saved_tick_handler;
+
+static inline __always_inline unsigned cpu_id() {
+    return SPR_READ(9) & 0xF;
+}
+
+void profiler_start(uint32_t period) {
+    struct profiler_histogram* histogram = &histograms[cpu_id()];
+
+    for (int i = 0; i < PROFILER_BUFFER_SIZE; i++) {
+        histogram->pcs[i] = 0;
+        histogram->counts[i] = 0;
+    }
+    histogram->period = period & TICK_TIME_PERIOD_MASK;
+    histogram->samples = 0;
+    histogram->dropped = 0;
+    histogram->handler_cycles = 0;
+
+    if (cpu_id() == 1 && _vectors[EXCEPTION_TICK_TIMER] != &profiler_tick_handler) {
+        saved_tick_handler = _vectors[EXCEPTION_TICK_TIMER];
+        _vectors[EXCEPTION_TICK_TIMER] = &profiler_tick_handler;
+    }
+
+    clearTickTimerCountRegister();
+    setTickTimerModeRegister(TICK_TIMER_CONTINUES_MODE | TICK_INTERRUPT_ENABLE_BIT | histogram->period);
+    enableTickTimerIrq(1);
+}
+
+void profiler_stop() {
+    enableTickTimerIrq(0);
+    setTickTimerModeRegister(TICK_TIMER_DISABLED);
+
+    if (cpu_id() == 1 && _vectors[EXCEPTION_TICK_TIMER] == &profiler_tick_handler)
+        _vectors[EXCEPTION_TICK_TIMER] = saved_tick_handler;
+}
+
+void profiler_tick_handler() {
+    struct profiler_histogram* histogram = &histograms[cpu_id()];
+    uint32_t pc = SPR_READ(SPR_EPC);
+    uint32_t i = (pc >> 2) & (PROFILER_BUFFER_SIZE - 1);
+
+    histogram->samples++;
+    for (int probe = 0;; probe++) {
+        if (probe == PROFILER_MAX_PROBES) {
+            histogram->dropped++;
+            break;
+        }
+        if (histogram->pcs[i] == pc) {
+            histogram->counts[i]++;
+            break;
+        }
+        if (histogram->pcs[i] == 0) {
+            histogram->pcs[i] = pc;
+            histogram->counts[i] = 1;
+            break;
+        }
+        i = (i + 1) & (PROFILER_BUFFER_SIZE - 1);
+    }
+
+    clearTickTimerIrq();
+
+    // the count register restarted at the timer match
+    histogram->handler_cycles += SPR_READ(TICK_TIMER_COUNT_REGISTER);
+}
+
+void profiler_dump(unsigned cpu) {
+    struct profiler_histogram* histogram = &histograms[cpu];
+    uint64_t elapsed = (uint64_t)histogram->samples * histogram->period;
+    uint64_t overhead = elapsed ? histogram->handler_cycles * 10000 / elapsed : 0;
+
+    printf("profile,cpu=%u,period=%u,samples=%u,dropped=%u,handler_cycles=%llu\n",
+           cpu, histogram->period, histogram->samples, histogram->dropped, histogram->handler_cycles);
+    for (int i = 0; i < PROFILER_BUFFER_SIZE; i++)
+        if (histogram->pcs[i])
+            printf("0x%08X %u\n", histogram->pcs[i], histogram->counts[i]);
+    printf("end\n");
+    printf("Profiler overhead: %llu.%02llu%% of the cycles\n", overhead / 100, overhead % 100);
+}
+
+#endif
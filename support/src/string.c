@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <string.h>
 
 // Sources:
@@ -8,96 +9,191 @@
  * sizeof(word) MUST BE A POWER OF TWO
  * SO THAT wmask BELOW IS ALL ONES
  */
-typedef int word; /* "word" used for optimal copy speed */
+typedef uint32_t __attribute__((may_alias)) word; /* "word" used for optimal copy speed */
 
 #define wsize sizeof(word)
 #define wmask (wsize - 1)
 
+/* assumed D$ line size, memset writes whole lines */
+#define lsize 32
+
+/* below this size, the alignment code costs more than it saves */
+#define small_size (2 * wsize)
+
+/*
+ * GCC recognizes the loops below as memcpy/memset and would replace them
+ * by calls to themselves; the former implementation prevented it with
+ * volatile pointers, which also prevented any unrolling.
+ */
+#define __no_builtin_loops __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+/*
+ * Merges two consecutive aligned source words into the word starting
+ * `shift` bits into the first one, in memory order.
+ */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define MERGE(w0, w1, shift) (((w0) << (shift)) | ((w1) >> (32 - (shift))))
+#else
+#define MERGE(w0, w1, shift) (((w0) >> (shift)) | ((w1) << (32 - (shift))))
+#endif
+
 /*
- * Copy a block of memory, handling overlap.
- * This is the routine that actually implements
- * (the portable versions of) bcopy, memcpy, and memmove.
+ * Copies whole words from an aligned source, 8 words (a D$ line) per iteration.
  */
-void* memcpy(void* dst0, const void* src0, size_t length) {
-    volatile char* dst = dst0;
+__no_builtin_loops static inline void copy_aligned(word* dst, const word* src, size_t words) {
+    for (; words >= 8; words -= 8) {
+        word w0 = src[0], w1 = src[1], w2 = src[2], w3 = src[3];
+        word w4 = src[4], w5 = src[5], w6 = src[6], w7 = src[7];
+        dst[0] = w0; dst[1] = w1; dst[2] = w2; dst[3] = w3;
+        dst[4] = w4; dst[5] = w5; dst[6] = w6; dst[7] = w7;
+        src += 8;
+        dst += 8;
+    }
+    while (words--)
+        *dst++ = *src++;
+}
+
+/*
+ * Copies whole words from a misaligned source: reads aligned words and
+ * shifts them into place, 4 words per iteration. Only reads the aligned
+ * words containing source bytes.
+ */
+__no_builtin_loops static inline void copy_shifted(word* dst, const char* src, size_t words) {
+    const unsigned shift = ((uintptr_t)src & wmask) * 8;
+    const word* s = (const word*)((uintptr_t)src & ~(uintptr_t)wmask);
+    word w0 = *s++;
+
+    for (; words >= 4; words -= 4) {
+        word w1 = s[0], w2 = s[1], w3 = s[2], w4 = s[3];
+        dst[0] = MERGE(w0, w1, shift);
+        dst[1] = MERGE(w1, w2, shift);
+        dst[2] = MERGE(w2, w3, shift);
+        dst[3] = MERGE(w3, w4, shift);
+        w0 = w4;
+        s += 4;
+        dst += 4;
+    }
+    while (words--) {
+        word w1 = *s++;
+        *dst++ = MERGE(w0, w1, shift);
+        w0 = w1;
+    }
+}
+
+/*
+ * Copy a block of memory forward. The destination is aligned first, then
+ * whole words are copied whatever the alignment of the source.
+ */
+__no_builtin_loops void* memcpy(void* dst0, const void* src0, size_t length) {
+    char* dst = dst0;
     const char* src = src0;
-    size_t t;
-
-    if (length == 0 || dst == src) /* nothing to do */
-        goto done;
-
-        /*
-         * Macros: loop-t-times; and loop-t-times, t>0
-         */
-#define TLOOP(s) \
-    if (t)       \
-    TLOOP1(s)
-#define TLOOP1(s) \
-    do {          \
-        s;        \
-    } while (--t)
-
-    if ((unsigned long)dst < (unsigned long)src) {
-        /*
-         * Copy forward.
-         */
-        t = (uintptr_t)src; /* only need low bits */
-        if ((t | (uintptr_t)dst) & wmask) {
-            /*
-             * Try to align operands.  This cannot be done
-             * unless the low bits match.
-             */
-            if ((t ^ (uintptr_t)dst) & wmask || length < wsize)
-                t = length;
-            else
-                t = wsize - (t & wmask);
-            length -= t;
-            TLOOP1(*dst++ = *src++);
-        }
-        /*
-         * Copy whole words, then mop up any trailing bytes.
-         */
-        t = length / wsize;
-        TLOOP(*(word*)dst = *(word*)src; src += wsize; dst += wsize);
-        t = length & wmask;
-        TLOOP(*dst++ = *src++);
-    } else {
-        /*
-         * Copy backwards.  Otherwise essentially the same.
-         * Alignment works as before, except that it takes
-         * (t&wmask) bytes to align, not wsize-(t&wmask).
-         */
-        src += length;
-        dst += length;
-        t = (uintptr_t)src;
-        if ((t | (uintptr_t)dst) & wmask) {
-            if ((t ^ (uintptr_t)dst) & wmask || length <= wsize)
-                t = length;
-            else
-                t &= wmask;
-            length -= t;
-            TLOOP1(*--dst = *--src);
+
+    if (length >= small_size) {
+        while ((uintptr_t)dst & wmask) {
+            *dst++ = *src++;
+            length--;
         }
-        t = length / wsize;
-        TLOOP(src -= wsize; dst -= wsize; *(word*)dst = *(word*)src);
-        t = length & wmask;
-        TLOOP(*--dst = *--src);
+
+        size_t words = length / wsize;
+        if ((uintptr_t)src & wmask)
+            copy_shifted((word*)dst, src, words);
+        else
+            copy_aligned((word*)dst, (const word*)src, words);
+
+        dst += words * wsize;
+        src += words * wsize;
+        length &= wmask;
     }
-done:
-    return (dst0);
+
+    while (length--)
+        *dst++ = *src++;
+
+    return dst0;
 }
 
-void* memmove(void* s1, const void* s2, size_t n) {
-    return memcpy(s1, s2, n);
+/*
+ * Copy a block of memory, handling overlap: copies backwards when the
+ * destination starts inside the source.
+ */
+__no_builtin_loops void* memmove(void* dst0, const void* src0, size_t length) {
+    char* dst = dst0;
+    const char* src = src0;
+
+    if (dst == src || length == 0)
+        return dst0;
+
+    if ((uintptr_t)dst - (uintptr_t)src >= length)
+        return memcpy(dst0, src0, length);
+
+    src += length;
+    dst += length;
+
+    if ((((uintptr_t)src ^ (uintptr_t)dst) & wmask) == 0 && length >= small_size) {
+        /* (t & wmask) bytes to align, not wsize - (t & wmask) */
+        while ((uintptr_t)dst & wmask) {
+            *--dst = *--src;
+            length--;
+        }
+        for (; length >= wsize; length -= wsize) {
+            src -= wsize;
+            dst -= wsize;
+            *(word*)dst = *(const word*)src;
+        }
+    }
+
+    while (length--)
+        *--dst = *--src;
+
+    return dst0;
 }
 
 void bcopy(const void* s1, void* s2, size_t n) {
-    memcpy(s2, s1, n);
+    memmove(s2, s1, n);
 }
 
-void* memset(void* dest, register int val, register size_t len) {
-    volatile unsigned char* ptr = (unsigned char*)dest;
-    while (len-- > 0)
+/*
+ * Fills the block word by word, whole D$ lines at a time once the
+ * destination is line-aligned.
+ */
+__no_builtin_loops void* memset(void* dest, register int val, register size_t len) {
+    unsigned char* ptr = dest;
+
+    if (len >= small_size) {
+        word w = (unsigned char)val;
+        w |= w << 8;
+        w |= w << 16;
+
+        while ((uintptr_t)ptr & wmask) {
+            *ptr++ = val;
+            len--;
+        }
+
+        word* p = (word*)ptr;
+        while (((uintptr_t)p & (lsize - 1)) && len >= wsize) {
+            *p++ = w;
+            len -= wsize;
+        }
+        for (; len >= lsize; len -= lsize) {
+            p[0] = w; p[1] = w; p[2] = w; p[3] = w;
+            p[4] = w; p[5] = w; p[6] = w; p[7] = w;
+            p += lsize / wsize;
+        }
+        for (; len >= wsize; len -= wsize)
+            *p++ = w;
+
+        ptr = (unsigned char*)p;
+    }
+
+    while (len--)
         *ptr++ = val;
+
     return dest;
 }
+
+int strcmp(const char* s1, const char* s2) {
+    while (*s1 && *s1 == *s2) {
+        s1++;
+        s2++;
+    }
+    return *(const unsigned char*)s1 - *(const unsigned char*)s2;
+}
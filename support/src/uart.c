@@ -5,6 +5,9 @@ void uart_init(volatile char* uart) {
     uart[0] = UART_SPEED_115200_LO;
     uart[1] = UART_SPEED_115200_HI;
     uart[UART_LINE_CONTROL_REGISTER] = UART_CL_8_BITS | UART_CL_1_STOP | UART_CL_NO_PARITY;
+#if UART_TX_BURST > 1
+    uart[UART_FIFO_CONTROL_REGISTER] = UART_FC_ENABLE | UART_FC_CLEAR_RX | UART_FC_CLEAR_TX;
+#endif
 }
 
 void uart_wait_rx(volatile char* uart) {
@@ -27,6 +30,17 @@ void uart_puts(volatile char* uart, const char* str) {
         uart_putc(uart, *str++);
 }
 
+void uart_write(volatile char* uart, const char* buf, unsigned len) {
+    while (len) {
+        unsigned burst = len < UART_TX_BURST ? len : UART_TX_BURST;
+
+        uart_wait_tx(uart);
+        len -= burst;
+        while (burst--)
+            *uart = *buf++;
+    }
+}
+
 int uart_getc(volatile char* uart) {
     uart_wait_rx(uart);
     return *uart;
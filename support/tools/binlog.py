@@ -0,0 +1,302 @@
+"""
+Decodes the output of `binlog_flush` (see `binlog.h`).
+
+usage:
+    python3 binlog.py <capture.txt> <program.elf> [--out decoded.txt]
+
+The capture is the raw UART output; lines outside of the logs are ignored.
+The format strings are read from the ELF and formatted like the embedded
+`printf` (support/src/printf.c), so the output is the one `printf` would have
+printed on the target.
+"""
+
+import argparse
+import dataclasses
+import pathlib
+import struct
+import sys
+from typing import *
+
+# see printf.c
+FLAGS_ZEROPAD = 1 << 0
+FLAGS_LEFT = 1 << 1
+FLAGS_PLUS = 1 << 2
+FLAGS_SPACE = 1 << 3
+FLAGS_HASH = 1 << 4
+FLAGS_UPPERCASE = 1 << 5
+FLAGS_CHAR = 1 << 6
+FLAGS_SHORT = 1 << 7
+FLAGS_LONG = 1 << 8
+FLAGS_LONG_LONG = 1 << 9
+FLAGS_PRECISION = 1 << 10
+
+NTOA_BUFFER_SIZE = 32
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+
+@dataclasses.dataclass
+class Section:
+    addr: int
+    data: bytes
+
+
+class Elf:
+    """Loaded sections of a 32-bit ELF."""
+
+    def __init__(self, fpath: pathlib.Path):
+        raw = fpath.read_bytes()
+        if raw[:4] != b"\x7fELF" or raw[4] != 1:
+            raise ValueError(f"{fpath}: not a 32-bit ELF")
+        endian = ">" if raw[5] == 2 else "<"
+
+        shoff, = struct.unpack_from(endian + "I", raw, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + "HH", raw, 0x2E)
+
+        self.sections: List[Section] = []
+        for i in range(shnum):
+            _, type, flags, addr, offset, size = struct.unpack_from(endian + "IIIIII", raw, shoff + i * shentsize)
+            if type == SHT_PROGBITS and flags & SHF_ALLOC:
+                self.sections.append(Section(addr, raw[offset:offset + size]))
+
+    def string(self, addr: int) -> Optional[bytes]:
+        for section in self.sections:
+            if section.addr <= addr < section.addr + len(section.data):
+                start = addr - section.addr
+                end = section.data.find(b"\0", start)
+                return section.data[start:end if end >= 0 else len(section.data)]
+        return None
+
+
+def ntoa(value: int, negative: bool, base: int, prec: int, width: int, flags: int) -> str:
+    """`_ntoa_long` and `_ntoa_format`, the digits are built in reverse."""
+    buf = []
+
+    if not value:
+        flags &= ~FLAGS_HASH
+
+    if not (flags & FLAGS_PRECISION) or value:
+        while True:
+            digit = value % base
+            buf.append(chr(ord("0") + digit) if digit < 10 else
+                       chr(ord("A" if flags & FLAGS_UPPERCASE else "a") + digit - 10))
+            value //= base
+            if not value or len(buf) >= NTOA_BUFFER_SIZE:
+                break
+
+    if not (flags & FLAGS_LEFT):
+        if width and (flags & FLAGS_ZEROPAD) and (negative or (flags & (FLAGS_PLUS | FLAGS_SPACE))):
+            width -= 1
+        while len(buf) < prec and len(buf) < NTOA_BUFFER_SIZE:
+            buf.append("0")
+        while (flags & FLAGS_ZEROPAD) and len(buf) < width and len(buf) < NTOA_BUFFER_SIZE:
+            buf.append("0")
+
+    if flags & FLAGS_HASH:
+        if not (flags & FLAGS_PRECISION) and buf and (len(buf) == prec or len(buf) == width):
+            buf.pop()
+            if buf and base == 16:
+                buf.pop()
+        if base == 16 and len(buf) < NTOA_BUFFER_SIZE:
+            buf.append("X" if flags & FLAGS_UPPERCASE else "x")
+        elif base == 2 and len(buf) < NTOA_BUFFER_SIZE:
+            buf.append("b")
+        if len(buf) < NTOA_BUFFER_SIZE:
+            buf.append("0")
+
+    if len(buf) < NTOA_BUFFER_SIZE:
+        if negative:
+            buf.append("-")
+        elif flags & FLAGS_PLUS:
+            buf.append("+")
+        elif flags & FLAGS_SPACE:
+            buf.append(" ")
+
+    # `_out_rev`
+    out = "".join(reversed(buf))
+    if not (flags & FLAGS_LEFT) and not (flags & FLAGS_ZEROPAD):
+        out = out.rjust(width)
+    if flags & FLAGS_LEFT:
+        out = out.ljust(width)
+    return out
+
+
+def signed(value: int, bits: int) -> int:
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+class Decoder:
+    def __init__(self, elf: Elf):
+        self.elf = elf
+
+    def format(self, fmt: bytes, words: Iterator[int]) -> str:
+        """`_vsnprintf`, the arguments are consumed from `words`."""
+        out = []
+        i = 0
+
+        def peek() -> str:
+            return chr(fmt[i]) if i < len(fmt) else "\0"
+
+        def atoi() -> int:
+            nonlocal i
+            n = 0
+            while peek().isdigit():
+                n = n * 10 + int(peek())
+                i += 1
+            return n
+
+        def arg64() -> int:
+            return (next(words) << 32) | next(words)
+
+        while i < len(fmt):
+            if peek() != "%":
+                out.append(peek())
+                i += 1
+                continue
+            i += 1
+
+            flags = 0
+            while peek() in "0-+ #":
+                flags |= {"0": FLAGS_ZEROPAD, "-": FLAGS_LEFT, "+": FLAGS_PLUS,
+                          " ": FLAGS_SPACE, "#": FLAGS_HASH}[peek()]
+                i += 1
+
+            width = 0
+            if peek().isdigit():
+                width = atoi()
+            elif peek() == "*":
+                w = signed(next(words), 32)
+                if w < 0:
+                    flags |= FLAGS_LEFT
+                    width = -w
+                else:
+                    width = w
+                i += 1
+
+            precision = 0
+            if peek() == ".":
+                flags |= FLAGS_PRECISION
+                i += 1
+                if peek().isdigit():
+                    precision = atoi()
+                elif peek() == "*":
+                    precision = max(signed(next(words), 32), 0)
+                    i += 1
+
+            if peek() == "l":
+                flags |= FLAGS_LONG
+                i += 1
+                if peek() == "l":
+                    flags |= FLAGS_LONG_LONG
+                    i += 1
+            elif peek() == "h":
+                flags |= FLAGS_SHORT
+                i += 1
+                if peek() == "h":
+                    flags |= FLAGS_CHAR
+                    i += 1
+            elif peek() == "j":
+                # intmax_t is long long
+                flags |= FLAGS_LONG_LONG
+                i += 1
+            elif peek() == "z":
+                # size_t is long
+                flags |= FLAGS_LONG
+                i += 1
+
+            spec = peek()
+            i += 1
+
+            if spec in "diuxXob":
+                base = {"x": 16, "X": 16, "o": 8, "b": 2}.get(spec, 10)
+                if base == 10:
+                    flags &= ~FLAGS_HASH
+                if spec == "X":
+                    flags |= FLAGS_UPPERCASE
+                if spec not in "di":
+                    flags &= ~(FLAGS_PLUS | FLAGS_SPACE)
+                if flags & FLAGS_PRECISION:
+                    flags &= ~FLAGS_ZEROPAD
+
+                bits = 64 if flags & FLAGS_LONG_LONG else 32
+                value = arg64() if bits == 64 else next(words)
+                if not (flags & FLAGS_LONG):
+                    bits = 8 if flags & FLAGS_CHAR else 16 if flags & FLAGS_SHORT else 32
+                if spec in "di":
+                    value = signed(value, bits)
+                    out.append(ntoa(abs(value), value < 0, base, precision, width, flags))
+                else:
+                    out.append(ntoa(value & ((1 << bits) - 1), False, base, precision, width, flags))
+
+            elif spec == "c":
+                c = chr(next(words) & 0xFF)
+                out.append(c.ljust(width) if flags & FLAGS_LEFT else c.rjust(width))
+
+            elif spec == "s":
+                addr = next(words)
+                raw = self.elf.string(addr)
+                s = raw.decode("latin-1") if raw is not None else f"<0x{addr:08X}>"
+                if flags & FLAGS_PRECISION:
+                    s = s[:precision]
+                out.append(s.ljust(width) if flags & FLAGS_LEFT else s.rjust(width))
+
+            elif spec == "p":
+                out.append(ntoa(next(words), False, 16, precision, 8, flags | FLAGS_ZEROPAD | FLAGS_UPPERCASE))
+
+            elif spec != "\0":
+                # including '%'
+                out.append(spec)
+
+        return "".join(out)
+
+    def decode(self, words: List[int]) -> str:
+        out = []
+        it = iter(words)
+        for addr in it:
+            fmt = self.elf.string(addr)
+            if fmt is None:
+                out.append(f"<binlog: unknown format 0x{addr:08X}, stopping>\n")
+                break
+            try:
+                out.append(self.format(fmt, it))
+            except StopIteration:
+                out.append("<binlog: truncated message>\n")
+        return "".join(out)
+
+
+def load_logs(fpath: pathlib.Path) -> List[Tuple[List[int], int]]:
+    """The words and the number of dropped messages of each flush."""
+    logs = []
+    words: Optional[List[int]] = None
+
+    with open(fpath, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("binlog,"):
+                fields = dict(item.split("=") for item in line.split(",")[1:])
+                words = []
+                logs.append((words, int(fields["dropped"])))
+            elif line == "binlog_end":
+                words = None
+            elif words is not None:
+                words.extend(int(w, 16) for w in line.split())
+
+    return logs
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="binlog decoder")
+    parser.add_argument("capture", type=pathlib.Path, help="UART output containing binlog_flush outputs")
+    parser.add_argument("elf", type=pathlib.Path, help="ELF of the program")
+    parser.add_argument("--out", type=pathlib.Path, default=None, help="output file, stdout by default")
+    args = parser.parse_args()
+
+    decoder = Decoder(Elf(args.elf))
+    out = open(args.out, "w") if args.out else sys.stdout
+
+    for words, dropped in load_logs(args.capture):
+        out.write(decoder.decode(words))
+        if dropped:
+            out.write(f"<binlog: {dropped} messages dropped>\n")
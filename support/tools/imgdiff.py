@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Compares two binary PPM (P6) images pixel by pixel.
+
+Prints the number of differing pixels and their bounding box, and optionally
+writes a diff image: differing pixels in red over a darkened copy of the first
+image. Exits with 1 if the images differ.
+
+    imgdiff.py a.ppm b.ppm [diff.ppm]
+"""
+
+import sys
+
+
+def read_ppm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        raise ValueError(f"{path}: not an 8-bit binary PPM")
+
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1:pos + 1 + width * height * 3]
+    return width, height, pixels
+
+
+def write_ppm(path, width, height, pixels):
+    with open(path, "wb") as f:
+        f.write(b"P6\n%d %d\n255\n" % (width, height))
+        f.write(pixels)
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    wa, ha, a = read_ppm(sys.argv[1])
+    wb, hb, b = read_ppm(sys.argv[2])
+    if (wa, ha) != (wb, hb):
+        print(f"size mismatch: {wa}x{ha} against {wb}x{hb}")
+        return 1
+
+    diff = bytearray(c // 4 for c in a)
+    count = 0
+    box = [wa, ha, -1, -1]
+    for i in range(0, len(a), 3):
+        if a[i:i + 3] != b[i:i + 3]:
+            x, y = (i // 3) % wa, (i // 3) // wa
+            box = [min(box[0], x), min(box[1], y), max(box[2], x), max(box[3], y)]
+            diff[i:i + 3] = b"\xff\x00\x00"
+            count += 1
+
+    if len(sys.argv) == 4:
+        write_ppm(sys.argv[3], wa, ha, bytes(diff))
+
+    if count:
+        print(f"{count} of {wa * ha} pixels differ, in ({box[0]}, {box[1]}) - ({box[2]}, {box[3]})")
+        return 1
+    print(f"identical, {wa}x{ha}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
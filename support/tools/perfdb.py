@@ -0,0 +1,203 @@
+"""
+Results database for the records printed by `perf_export.h`.
+
+usage:
+    python3 perfdb.py ingest <capture.txt>... [--db perf.db]
+    python3 perfdb.py export <out.csv> [--db perf.db]
+    python3 perfdb.py compare <old build> <new build> [--threshold 5] [--db perf.db]
+    python3 perfdb.py plot <name> <key> [--config <config>] [--out plot.pdf] [--db perf.db]
+
+The capture is the raw UART output; lines that are not records are ignored.
+"""
+
+import argparse
+import csv
+import dataclasses
+import datetime
+import json
+import pathlib
+import sqlite3
+from typing import *
+
+CSV_TAG = "perf"
+JSON_TAG = "{\"perf\":"
+
+
+@dataclasses.dataclass
+class Record:
+    run: int
+    build: str
+    name: str
+    config: str
+    values: Dict[str, int] = dataclasses.field(default_factory=dict)
+
+    def params(self) -> Dict[str, str]:
+        return parse_config(self.config)
+
+
+def parse_config(config: str) -> Dict[str, str]:
+    """`"count=16,packed=1"` -> `{"count": "16", "packed": "1"}`"""
+    params = {}
+    for item in config.split(","):
+        key, sep, value = item.partition("=")
+        if sep:
+            params[key.strip()] = value.strip()
+    return params
+
+
+def load_capture(fpath: pathlib.Path) -> List[Record]:
+    """Parses the CSV and JSON lines records of a capture, in order."""
+    records: List[Record] = []
+
+    with open(fpath, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+
+            if line.startswith(JSON_TAG):
+                try:
+                    obj = json.loads(line)
+                except json.JSONDecodeError:
+                    continue
+                records.append(Record(obj["run"], obj["build"], obj["name"], obj["config"],
+                                      {k: int(v) for k, v in obj["values"].items()}))
+
+            elif line.startswith(CSV_TAG + ","):
+                fields = next(csv.reader([line]))
+                if len(fields) != 7:
+                    continue
+                _, run, build, name, config, key, value = fields
+                last = records[-1] if records else None
+                # consecutive values of the same record share the same columns
+                if last is None or (last.run, last.build, last.name, last.config) != (int(run), build, name, config) \
+                        or key in last.values:
+                    last = Record(int(run), build, name, config)
+                    records.append(last)
+                last.values[key] = int(value)
+
+    return records
+
+
+def connect(db: pathlib.Path) -> sqlite3.Connection:
+    conn = sqlite3.connect(db)
+    conn.execute("""
+        CREATE TABLE IF NOT EXISTS results (
+            capture TEXT, ingested TEXT, record INTEGER,
+            run INTEGER, build TEXT, name TEXT, config TEXT,
+            key TEXT, value INTEGER
+        )
+    """)
+    return conn
+
+
+def ingest(conn: sqlite3.Connection, captures: List[pathlib.Path]) -> None:
+    now = datetime.datetime.now().isoformat(timespec="seconds")
+    for capture in captures:
+        records = load_capture(capture)
+        conn.executemany(
+            "INSERT INTO results VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+            [(str(capture), now, i, r.run, r.build, r.name, r.config, k, v)
+             for i, r in enumerate(records) for k, v in r.values.items()]
+        )
+        print(f"{capture}: {len(records)} records")
+    conn.commit()
+
+
+def export(conn: sqlite3.Connection, out: pathlib.Path) -> None:
+    rows = conn.execute("SELECT * FROM results ORDER BY ingested, capture, record").fetchall()
+    with open(out, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["capture", "ingested", "record", "run", "build", "name", "config", "key", "value"])
+        writer.writerows(rows)
+    print(f"{out}: {len(rows)} rows")
+
+
+def averages(conn: sqlite3.Connection, build: str) -> Dict[Tuple[str, str, str], float]:
+    rows = conn.execute(
+        "SELECT name, config, key, AVG(value) FROM results WHERE build = ? GROUP BY name, config, key",
+        (build,)
+    ).fetchall()
+    return {(name, config, key): value for name, config, key, value in rows}
+
+
+def compare(conn: sqlite3.Connection, old: str, new: str, threshold: float) -> int:
+    """Prints the values that changed by more than `threshold` percent. Returns the number of regressions."""
+    a = averages(conn, old)
+    b = averages(conn, new)
+    regressions = 0
+
+    for k in sorted(a.keys() & b.keys()):
+        if a[k] == 0:
+            continue
+        change = 100 * (b[k] - a[k]) / a[k]
+        if abs(change) >= threshold:
+            # every exported value is a cost: cycles, misses, stalls...
+            kind = "REGRESSION" if change > 0 else "improvement"
+            regressions += change > 0
+            name, config, key = k
+            print(f"{kind:<12} {name} [{config}] {key}: {a[k]:.0f} -> {b[k]:.0f} ({change:+.1f}%)")
+
+    print(f"{regressions} regressions above {threshold}% between {old} and {new}")
+    return regressions
+
+
+def plot(conn: sqlite3.Connection, name: str, key: str, config: Optional[str], out: pathlib.Path) -> None:
+    import matplotlib.pyplot as plt
+
+    query = "SELECT build, config, AVG(value), MIN(ingested) FROM results WHERE name = ? AND key = ?"
+    args: List[Any] = [name, key]
+    if config is not None:
+        query += " AND config = ?"
+        args.append(config)
+    rows = conn.execute(query + " GROUP BY build, config ORDER BY MIN(ingested)", args).fetchall()
+
+    series: Dict[str, List[Tuple[str, float]]] = {}
+    for build, cfg, value, _ in rows:
+        series.setdefault(cfg, []).append((build, value))
+
+    fig = plt.figure(figsize=[10, 6])
+    axes = fig.add_axes([0.10, 0.25, 0.85, 0.65])
+    axes.set_title(f"{name}: {key}", fontdict={"weight": "bold"})
+    axes.set_xlabel("Build", fontdict={"weight": "bold"})
+    axes.set_ylabel(key, fontdict={"weight": "bold"})
+    axes.grid()
+    for cfg, points in series.items():
+        axes.plot([p[0] for p in points], [p[1] for p in points], label=cfg or name, marker="o")
+    axes.tick_params(axis="x", labelrotation=45)
+    axes.legend()
+    fig.savefig(out)
+    print(f"{out}: {len(series)} series")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="performance results database")
+    parser.add_argument("--db", type=pathlib.Path, default=pathlib.Path("perf.db"), help="SQLite database")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    p = commands.add_parser("ingest", help="add UART captures to the database")
+    p.add_argument("captures", type=pathlib.Path, nargs="+")
+
+    p = commands.add_parser("export", help="dump the database as CSV")
+    p.add_argument("out", type=pathlib.Path)
+
+    p = commands.add_parser("compare", help="compare two builds")
+    p.add_argument("old")
+    p.add_argument("new")
+    p.add_argument("--threshold", type=float, default=5.0, help="minimum change, in percent")
+
+    p = commands.add_parser("plot", help="plot a value across builds")
+    p.add_argument("name")
+    p.add_argument("key")
+    p.add_argument("--config", default=None)
+    p.add_argument("--out", type=pathlib.Path, default=pathlib.Path("plot.pdf"))
+
+    args = parser.parse_args()
+    conn = connect(args.db)
+
+    if args.command == "ingest":
+        ingest(conn, args.captures)
+    elif args.command == "export":
+        export(conn, args.out)
+    elif args.command == "compare":
+        exit(1 if compare(conn, args.old, args.new, args.threshold) else 0)
+    elif args.command == "plot":
+        plot(conn, args.name, args.key, args.config, args.out)
@@ -0,0 +1,122 @@
+"""
+Maps the PC histograms printed by `profiler_dump` to functions (and
+optionally source lines) using the symbol table of the ELF.
+
+usage: python3 profile.py <capture.txt> <program.elf> [--lines] [--toolchain or1k-elf]
+"""
+
+import argparse
+import bisect
+import collections
+import dataclasses
+import pathlib
+import re
+import subprocess
+from typing import *
+
+HEADER_REGEX = r"^profile,cpu=(\d+),period=(\d+),samples=(\d+),dropped=(\d+),handler_cycles=(\d+)$"
+SAMPLE_REGEX = r"^0x([0-9A-Fa-f]+) (\d+)$"
+
+
+@dataclasses.dataclass
+class Profile:
+    cpu: int
+    period: int
+    samples: int
+    dropped: int
+    handler_cycles: int
+    counts: Dict[int, int] = dataclasses.field(default_factory=dict)
+
+
+def load_profiles(fpath: pathlib.Path) -> List[Profile]:
+    profiles: List[Profile] = []
+    current: Optional[Profile] = None
+
+    with open(fpath, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            match = re.match(HEADER_REGEX, line)
+            if match:
+                current = Profile(*map(int, match.groups()))
+                profiles.append(current)
+                continue
+            if line == "end":
+                current = None
+                continue
+            match = re.match(SAMPLE_REGEX, line)
+            if current is not None and match:
+                current.counts[int(match.group(1), 16)] = int(match.group(2))
+
+    return profiles
+
+
+class Symbols:
+    def __init__(self, elf: pathlib.Path, toolchain: str):
+        self.elf = elf
+        self.toolchain = toolchain
+        self.addresses: List[int] = []
+        self.names: List[str] = []
+
+        out = subprocess.run(
+            [f"{toolchain}-nm", "-n", "-C", str(elf)],
+            check=True, capture_output=True, text=True
+        ).stdout
+        for line in out.splitlines():
+            fields = line.split(maxsplit=2)
+            if len(fields) == 3 and fields[1] in "tTwW":
+                self.addresses.append(int(fields[0], 16))
+                self.names.append(fields[2])
+
+    def function(self, pc: int) -> str:
+        i = bisect.bisect_right(self.addresses, pc) - 1
+        return self.names[i] if i >= 0 else f"0x{pc:08x}"
+
+    def lines(self, pcs: List[int]) -> Dict[int, str]:
+        out = subprocess.run(
+            [f"{self.toolchain}-addr2line", "-e", str(self.elf)] + [f"0x{pc:x}" for pc in pcs],
+            check=True, capture_output=True, text=True
+        ).stdout
+        return dict(zip(pcs, out.splitlines()))
+
+
+def report(profile: Profile, symbols: Symbols, lines: bool, top: int) -> None:
+    recorded = sum(profile.counts.values())
+    elapsed = profile.samples * profile.period
+    overhead = 100 * profile.handler_cycles / elapsed if elapsed else 0
+
+    print(f"CPU {profile.cpu}: {profile.samples} samples every {profile.period} cycles, "
+          f"{profile.dropped} dropped, overhead {overhead:.2f}%")
+
+    if not recorded:
+        print("  no samples recorded")
+        return
+
+    functions: Dict[str, int] = collections.Counter()
+    for pc, count in profile.counts.items():
+        functions[symbols.function(pc)] += count
+
+    print(f"  {'samples':>8} {'%':>6}  function")
+    for name, count in functions.most_common(top):
+        print(f"  {count:>8} {100 * count / recorded:>6.2f}  {name}")
+
+    if lines:
+        pcs = [pc for pc, _ in sorted(profile.counts.items(), key=lambda x: -x[1])[:top]]
+        locations = symbols.lines(pcs)
+        print(f"  {'samples':>8} {'%':>6}  line")
+        for pc in pcs:
+            count = profile.counts[pc]
+            print(f"  {count:>8} {100 * count / recorded:>6.2f}  {locations[pc]} ({symbols.function(pc)})")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="PC-sampling profile report")
+    parser.add_argument("capture", type=pathlib.Path, help="UART capture containing `profiler_dump` output")
+    parser.add_argument("elf", type=pathlib.Path, help="profiled program")
+    parser.add_argument("--lines", action="store_true", help="also report the hottest source lines")
+    parser.add_argument("--top", type=int, default=20, help="number of rows per report")
+    parser.add_argument("--toolchain", default="or1k-elf", help="toolchain prefix")
+    args = parser.parse_args()
+
+    symbols = Symbols(args.elf, args.toolchain)
+    for profile in load_profiles(args.capture):
+        report(profile, symbols, args.lines, args.top)
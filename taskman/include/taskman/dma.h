@@ -0,0 +1,46 @@
+#ifndef TASKMAN_DMA_H_INCLUDED
+#define TASKMAN_DMA_H_INCLUDED
+
+#include <dma.h>
+#include <stdint.h>
+
+#include "taskman.h"
+
+/// @brief CPU that owns the DMA, its status register and the SPM it transfers to.
+#define TASKMAN_DMA_CPU 1
+
+/**
+ * @brief Initializes the DMA module for taskman.
+ *
+ * The handler polls the driver at each main loop iteration of `TASKMAN_DMA_CPU`,
+ * which chains the queued transfers. Only tasks pinned to that CPU may use the
+ * DMA, through this module and not directly: the other CPUs would read the
+ * status of their own, idle, DMA.
+ *
+ */
+void taskman_dma_glinit();
+
+/**
+ * @brief Queues a transfer without waiting for it.
+ *
+ * @param desc
+ */
+void taskman_dma_submit(struct dma_desc* desc);
+
+/**
+ * @brief Waits asynchronously for a transfer queued by `taskman_dma_submit`.
+ *
+ * @param desc
+ * @return uint32_t Error bits of the transfer, 0 on success.
+ */
+uint32_t taskman_dma_wait(struct dma_desc* desc);
+
+/**
+ * @brief Queues a transfer and waits asynchronously for it.
+ *
+ * @param desc
+ * @return uint32_t Error bits of the transfer, 0 on success.
+ */
+uint32_t taskman_dma_transfer(struct dma_desc* desc);
+
+#endif /* TASKMAN_DMA_H_INCLUDED */
@@ -0,0 +1,41 @@
+#ifndef TASKMAN_MAILBOX_H_INCLUDED
+#define TASKMAN_MAILBOX_H_INCLUDED
+
+#include <mailbox.h>
+#include <stdint.h>
+
+#include "taskman.h"
+
+/**
+ * @brief Initializes the mailbox module for taskman.
+ *
+ * @note Call `mailbox_glinit` beforehand.
+ *
+ */
+void taskman_mailbox_glinit();
+
+/**
+ * @brief Sends a message to a CPU, waits while the ring is full.
+ *
+ * @note The message is sent from the CPU that called this function, once
+ * the ring has room: the task resumes on that CPU only, and the receiver
+ * sees the message coming from it.
+ *
+ * @param dst Destination CPU id.
+ * @param msg Message.
+ */
+void taskman_mailbox_send(uint32_t dst, mailbox_msg_t msg);
+
+/**
+ * @brief Waits for a message sent by a CPU to the CPU running the task.
+ *
+ * @note Messages are addressed to CPUs, not tasks: the message is taken
+ * from the ring of the CPU that called this function, and the task resumes
+ * on that CPU only.
+ *
+ * @param src Source CPU id.
+ * @return mailbox_msg_t Received message.
+ */
+mailbox_msg_t taskman_mailbox_recv(uint32_t src);
+
+#endif /* TASKMAN_MAILBOX_H_INCLUDED */
@@ -2,6 +2,51 @@
 #define TASKMAN_TASKMAN_H_INCLUDED
 
 #include <coro/coro.h>
+#include <stdint.h>
+
+/// @brief CPU mask bit for the CPU with the given id (as read from SPR 9).
+#define TASKMAN_CPU_MASK(cpu_id) (((uint32_t)1) << (cpu_id))
+
+/// @brief CPU mask matching every CPU.
+#define TASKMAN_CPU_MASK_ALL (~(uint32_t)0)
+
+#ifndef TASKMAN_STATS_COUNTER
+/// @brief Performance counter sampled around each resume.
+/// The application selects the counted event with `perf_set_mask`.
+#define TASKMAN_STATS_COUNTER 7
+#endif
+
+/**
+ * @brief Scheduling policy of a task with respect to the CPUs.
+ *
+ */
+enum taskman_affinity {
+    /// @brief The task may run on any CPU. The scheduler keeps it on the
+    /// CPU it last ran on unless that CPU is overloaded.
+    TASKMAN_AFFINITY_ANY,
+
+    /// @brief The task prefers the CPUs of its mask, but may be stolen by
+    /// another CPU if the load imbalance is above the threshold.
+    TASKMAN_AFFINITY_PREFERRED,
+
+    /// @brief The task only runs on the CPUs of its mask.
+    TASKMAN_AFFINITY_PINNED
+};
+
+/**
+ * @brief Per-task scheduling statistics.
+ *
+ */
+struct taskman_stats {
+    /// @brief Number of times the task has been resumed.
+    uint32_t resumes;
+
+    /// @brief Number of resumes that happened on a different CPU than the previous one.
+    uint32_t migrations;
+
+    /// @brief Events counted by `TASKMAN_STATS_COUNTER` while the task was running.
+    uint64_t events;
+};
 
 struct taskman_handler {
     /**
@@ -46,6 +91,46 @@ void taskman_glinit();
  */
 void* taskman_spawn(coro_fn_t coro_fn, void* arg, size_t stack_sz);
 
+/**
+ * @brief Sets the CPU affinity of a task.
+ *
+ * @param stack Task returned by `taskman_spawn`.
+ * @param affinity Scheduling policy.
+ * @param cpu_mask CPUs the policy refers to, see `TASKMAN_CPU_MASK`.
+ * Ignored for `TASKMAN_AFFINITY_ANY`.
+ */
+void taskman_set_affinity(void* stack, enum taskman_affinity affinity, uint32_t cpu_mask);
+
+/**
+ * @brief Enables or disables the cache-warm rescheduling.
+ *
+ * @note When disabled, the "last CPU" hint and the preferred CPUs are
+ * ignored. Pinned tasks are always honoured.
+ *
+ * @param enable 1 to enable (default), 0 to disable.
+ */
+void taskman_affinity_enable(int enable);
+
+/**
+ * @brief Reads the scheduling statistics of a task.
+ *
+ * @param stack Task returned by `taskman_spawn`.
+ * @param stats Output statistics.
+ */
+void taskman_get_stats(void* stack, struct taskman_stats* stats);
+
+/**
+ * @brief Resets the scheduling statistics of all the tasks.
+ *
+ */
+void taskman_reset_stats();
+
+/**
+ * @brief Prints the names of the wait handlers, for the `TRACE_TASK_WAIT` events of `trace_dump`.
+ *
+ */
+void taskman_trace_names();
+
 /**
  * @brief Executes the main loop of the task manager.
  *
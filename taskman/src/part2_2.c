@@ -1,17 +1,58 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <assert.h>
 #include <cache.h>
 #include <cpu2.h>
+#include <dma.h>
 #include <locks.h>
+#include <mailbox.h>
+#include <perf.h>
+#include <profiler.h>
 #include <swap.h>
+#include <tick.h>
+#include <trace.h>
 
+#include <taskman/dma.h>
+#include <taskman/mailbox.h>
 #include <taskman/taskman.h>
 
 #include <coro/coro.h>
 
 #define STDOUT_LOCK_ID 0
 
+/// @brief Number of `stats_task` iterations between two reports.
+/// Each report toggles the cache-warm rescheduling to compare both modes.
+#define STATS_PERIOD 64
+
+/// @brief Coherent data cache configuration shared by both CPUs.
+#define DCACHE_CFG (CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK | CACHE_COHERENCE | CACHE_MESI)
+
+/// @brief CPUs exchanging messages in the mailbox benchmark.
+#define BENCH_PING_CPU 1
+#define BENCH_PONG_CPU 2
+
+/// @brief Number of round trips of the ping-pong benchmarks.
+#define BENCH_ROUNDS 256
+
+/// @brief Number of messages of the streaming benchmark.
+#define BENCH_STREAM 4096
+
+/// @brief CPU whose taskman loop is profiled.
+#define PROFILE_CPU 2
+
+/// @brief Yields of the profiling task while its CPU is sampled.
+#define PROFILE_YIELDS 4096
+
+/// @brief SPM region of the DMA benchmark, the start of the SPM of `TASKMAN_DMA_CPU`.
+#define BENCH_DMA_SPM DMA_SPM_ADDRESS
+
+/// @brief Size of a transfer of the DMA benchmark, in words.
+#define BENCH_DMA_WORDS 256
+
+/// @brief Number of round trips (memory to SPM and back) of the DMA benchmark.
+#define BENCH_DMA_ROUNDS 64
+
 // thread-safe printf macro
 #define mt_printf(fmt, ...)                     \
     do {                                        \
@@ -71,6 +112,56 @@ static void bouncing_ball_task() {
     }
 }
 
+__global static struct {
+    /// @brief Tasks whose statistics are reported.
+    void* tasks[8];
+
+    /// @brief Number of tasks whose statistics are reported.
+    size_t count;
+} stats;
+
+/**
+ * @brief Counts data cache misses per resume, with the cache-warm
+ * rescheduling successively enabled and disabled.
+ *
+ */
+static void stats_task() {
+    int affinity = 1;
+    int traced = 0;
+
+    while (1) {
+        for (int i = 0; i < STATS_PERIOD; i++)
+            taskman_yield();
+
+        get_lock(STDOUT_LOCK_ID);
+        printf("stats_task: affinity = %s\n", affinity ? "on" : "off");
+        for (size_t i = 0; i < stats.count; i++) {
+            struct taskman_stats task_stats;
+            taskman_get_stats(stats.tasks[i], &task_stats);
+
+            uint32_t resumes = task_stats.resumes ? task_stats.resumes : 1;
+            printf(
+                "  task %u: resumes = %u, migrations = %u, D$ misses = %llu (%llu per resume)\n",
+                i, task_stats.resumes, task_stats.migrations,
+                task_stats.events, task_stats.events / resumes
+            );
+        }
+
+        /* the first period is traced, see tools/trace2chrome.py */
+        if (!traced) {
+            trace_enable(0);
+            taskman_trace_names();
+            trace_dump();
+            traced = 1;
+        }
+        release_lock(STDOUT_LOCK_ID);
+
+        affinity = !affinity;
+        taskman_affinity_enable(affinity);
+        taskman_reset_stats();
+    }
+}
+
 static void print_task() {
     while (1) {
         mt_printf("print_task: arg = %s, cpu id = %d\n", coro_arg(), cpu_id());
@@ -80,9 +171,166 @@ static void print_task() {
     }
 }
 
+__global static uint32_t dma_buffer[BENCH_DMA_WORDS] __aligned(32);
+
+/**
+ * @brief Moves a buffer to the SPM and back through `taskman_dma_transfer`,
+ * while the demo tasks run, and checks it.
+ *
+ */
+static void dma_task() {
+    struct dma_desc desc;
+    perf_cycles_t start, cycles;
+
+    for (int i = 0; i < BENCH_DMA_WORDS; i++)
+        dma_buffer[i] = i * 0x9E3779B9u;
+
+    start = perf_read_counter(PERF_COUNTER_RUNTIME);
+    for (int r = 0; r < BENCH_DMA_ROUNDS; r++) {
+        /* the DMA reads the memory, not the D$ */
+        dcache_flush();
+        dma_desc_init(&desc, dma_buffer, BENCH_DMA_SPM, BENCH_DMA_WORDS, DMA_FROM_MEM_TO_SPM);
+        die_if_not(taskman_dma_transfer(&desc) == 0);
+
+        for (int i = 0; i < BENCH_DMA_WORDS; i++)
+            dma_buffer[i] = 0;
+        dcache_flush();
+
+        dma_desc_init(&desc, dma_buffer, BENCH_DMA_SPM, BENCH_DMA_WORDS, DMA_FROM_SPM_TO_MEM);
+        die_if_not(taskman_dma_transfer(&desc) == 0);
+        dcache_flush();
+
+        for (int i = 0; i < BENCH_DMA_WORDS; i++)
+            die_if_not(dma_buffer[i] == i * 0x9E3779B9u);
+    }
+    cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+    mt_printf("dma: round trip of %u bytes = %llu cycles (taskman)\n",
+              BENCH_DMA_WORDS * 4, cycles / BENCH_DMA_ROUNDS);
+}
+
+/**
+ * @brief Samples the PC of its CPU while the taskman loop runs the demo tasks
+ * and prints the histogram, see `support/tools/profile.py`.
+ *
+ * @note The counters of the profiled CPU stop at each sample, so the D$ misses
+ * reported by `stats_task` for that CPU are low while it runs.
+ *
+ */
+static void profile_task() {
+    profiler_start(PROFILER_DEFAULT_PERIOD);
+    for (int i = 0; i < PROFILE_YIELDS; i++)
+        taskman_yield();
+    profiler_stop();
+
+    /* trace timestamps, reset by the profiler */
+    tick_glinit();
+
+    get_lock(STDOUT_LOCK_ID);
+    profiler_dump(cpu_id());
+    release_lock(STDOUT_LOCK_ID);
+}
+
+/// @brief Tick timer handler of CPU 2, the `PROFILE_CPU`.
+void tick_timer_handler2() {
+    profiler_tick_handler();
+}
+
+static void spawn_demo_tasks() {
+    stats.count = 0;
+    stats.tasks[stats.count++] = taskman_spawn(&print_task, "task1", 1024);
+    stats.tasks[stats.count++] = taskman_spawn(&print_task, "task2", 1024);
+    stats.tasks[stats.count++] = taskman_spawn(&print_task, "task3", 1024);
+    stats.tasks[stats.count++] = taskman_spawn(&print_task, "task4", 1024);
+    stats.tasks[stats.count++] = taskman_spawn(&bouncing_ball_task, NULL, 4096);
+
+    /* the ball always lights its LEDs from CPU 1, the reporter prefers CPU 2 */
+    taskman_set_affinity(stats.tasks[4], TASKMAN_AFFINITY_PINNED, TASKMAN_CPU_MASK(1));
+    taskman_set_affinity(
+        taskman_spawn(&stats_task, NULL, 2048),
+        TASKMAN_AFFINITY_PREFERRED, TASKMAN_CPU_MASK(2)
+    );
+
+    taskman_set_affinity(
+        taskman_spawn(&profile_task, NULL, 2048),
+        TASKMAN_AFFINITY_PINNED, TASKMAN_CPU_MASK(PROFILE_CPU)
+    );
+
+    /* the DMA and its SPM belong to one CPU */
+    taskman_set_affinity(
+        taskman_spawn(&dma_task, NULL, 2048),
+        TASKMAN_AFFINITY_PINNED, TASKMAN_CPU_MASK(TASKMAN_DMA_CPU)
+    );
+}
+
+/**
+ * @brief Echoes the messages of `mailbox_ping_task`, then sums the stream.
+ *
+ */
+static void mailbox_pong_task() {
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+        mailbox_send_blocking(BENCH_PING_CPU, mailbox_recv_blocking(BENCH_PING_CPU));
+
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+        taskman_mailbox_send(BENCH_PING_CPU, taskman_mailbox_recv(BENCH_PING_CPU));
+
+    mailbox_msg_t sum = 0;
+    for (int i = 0; i < BENCH_STREAM; i++)
+        sum += mailbox_recv_blocking(BENCH_PING_CPU);
+    mailbox_send_blocking(BENCH_PING_CPU, sum);
+}
+
+/**
+ * @brief Measures the cross-core latency (spinning and through the task
+ * manager) and the streaming bandwidth of the mailbox.
+ *
+ */
+static void mailbox_ping_task() {
+    perf_cycles_t start, spin, wait, stream;
+
+    start = perf_read_counter(PERF_COUNTER_RUNTIME);
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        mailbox_send_blocking(BENCH_PONG_CPU, i);
+        die_if_not(mailbox_recv_blocking(BENCH_PONG_CPU) == (mailbox_msg_t)i);
+    }
+    spin = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+    start = perf_read_counter(PERF_COUNTER_RUNTIME);
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        taskman_mailbox_send(BENCH_PONG_CPU, i);
+        die_if_not(taskman_mailbox_recv(BENCH_PONG_CPU) == (mailbox_msg_t)i);
+    }
+    wait = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+    mailbox_msg_t sum = 0;
+    start = perf_read_counter(PERF_COUNTER_RUNTIME);
+    for (int i = 0; i < BENCH_STREAM; i++) {
+        mailbox_send_blocking(BENCH_PONG_CPU, i);
+        sum += i;
+    }
+    die_if_not(mailbox_recv_blocking(BENCH_PONG_CPU) == sum);
+    stream = perf_read_counter(PERF_COUNTER_RUNTIME) - start;
+
+    get_lock(STDOUT_LOCK_ID);
+    printf("mailbox: round trip = %llu cycles (spin), %llu cycles (taskman)\n",
+           spin / BENCH_ROUNDS, wait / BENCH_ROUNDS);
+    printf("mailbox: stream = %llu cycles per message, %llu bytes per kcycle\n",
+           stream / BENCH_STREAM, (BENCH_STREAM * sizeof(mailbox_msg_t) * 1000ull) / stream);
+    release_lock(STDOUT_LOCK_ID);
+
+    spawn_demo_tasks();
+}
+
 int __no_optimize main2() {
     icache_enable(0);
-    dcache_enable(0);
+    dcache_write_cfg(DCACHE_CFG);
+    dcache_enable(1);
+
+    perf_set_mask(TASKMAN_STATS_COUNTER, PERF_DCACHE_MISS_MASK);
+    perf_start();
+
+    /* trace timestamps: only CPU 1 starts its tick timer in `platform_glinit` */
+    tick_glinit();
 
     coro_glinit();
 
@@ -98,15 +346,32 @@ int __no_optimize part2_2() {
 
     mt_printf("CPU with id %d is working!\n", cpu_id());
 
+    /* D$ misses per resume are the measure of the cache-warm rescheduling */
+    dcache_write_cfg(DCACHE_CFG);
+    dcache_enable(1);
+
+    perf_set_mask(TASKMAN_STATS_COUNTER, PERF_DCACHE_MISS_MASK);
+    perf_start();
+
     coro_glinit();
     taskman_glinit();
 
-    /* spawn tasks */
-    taskman_spawn(&print_task, "task1", 1024);
-    taskman_spawn(&print_task, "task2", 1024);
-    taskman_spawn(&print_task, "task3", 1024);
-    taskman_spawn(&print_task, "task4", 1024);
-    taskman_spawn(&bouncing_ball_task, NULL, 4096);
+    mailbox_glinit(0);
+    taskman_mailbox_glinit();
+
+    taskman_dma_glinit();
+
+    trace_glinit();
+
+    /* the demo tasks are spawned once the mailbox benchmark is over */
+    taskman_set_affinity(
+        taskman_spawn(&mailbox_ping_task, NULL, 4096),
+        TASKMAN_AFFINITY_PINNED, TASKMAN_CPU_MASK(BENCH_PING_CPU)
+    );
+    taskman_set_affinity(
+        taskman_spawn(&mailbox_pong_task, NULL, 4096),
+        TASKMAN_AFFINITY_PINNED, TASKMAN_CPU_MASK(BENCH_PONG_CPU)
+    );
 
     /* start the other CPU */
     SET_CPU2_MAIN(&init_cpu2);
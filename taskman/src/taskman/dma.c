@@ -0,0 +1,89 @@
+#include <assert.h>
+#include <defs.h>
+#include <dma.h>
+#include <spr.h>
+#include <taskman/dma.h>
+
+__global static struct taskman_handler dma_handler;
+
+struct wait_data {
+    struct dma_desc* desc;
+
+    /// @brief 0 to wait, 1 to submit.
+    int operation;
+};
+
+static inline __always_inline uint32_t cpu_id() {
+    return SPR_READ(9) & 0xF;
+}
+
+/*
+ * The handler callbacks run under the taskman lock, and call the driver on
+ * TASKMAN_DMA_CPU only.
+ */
+static int on_wait(struct taskman_handler* handler, void* stack, void* arg) {
+    UNUSED(handler);
+    UNUSED(stack);
+
+    struct wait_data* wait_data = (struct wait_data*)arg;
+    if (wait_data->operation == 1) {
+        dma_submit(wait_data->desc);
+        return 1;
+    }
+
+    return dma_poll(wait_data->desc);
+}
+
+static int can_resume(struct taskman_handler* handler, void* stack, void* arg) {
+    UNUSED(handler);
+    UNUSED(stack);
+
+    struct wait_data* wait_data = (struct wait_data*)arg;
+    return wait_data->desc->state == DMA_DESC_DONE;
+}
+
+static void loop(struct taskman_handler* handler) {
+    UNUSED(handler);
+
+    if (cpu_id() != TASKMAN_DMA_CPU)
+        return;
+
+    /* completes the active transfer and starts the next one */
+    dma_poll(NULL);
+}
+
+void taskman_dma_glinit() {
+    dma_handler.name = "dma";
+    dma_handler.on_wait = &on_wait;
+    dma_handler.can_resume = &can_resume;
+    dma_handler.loop = &loop;
+
+    taskman_register(&dma_handler);
+}
+
+void __no_optimize taskman_dma_submit(struct dma_desc* desc) {
+    struct wait_data wait_data;
+    wait_data.desc = desc;
+    wait_data.operation = 1;
+
+    die_if_not(cpu_id() == TASKMAN_DMA_CPU);
+
+    taskman_wait(&dma_handler, &wait_data);
+}
+
+uint32_t __no_optimize taskman_dma_wait(struct dma_desc* desc) {
+    struct wait_data wait_data;
+    wait_data.desc = desc;
+    wait_data.operation = 0;
+
+    die_if_not(cpu_id() == TASKMAN_DMA_CPU);
+
+    taskman_wait(&dma_handler, &wait_data);
+
+    return desc->errors;
+}
+
+uint32_t taskman_dma_transfer(struct dma_desc* desc) {
+    taskman_dma_submit(desc);
+    return taskman_dma_wait(desc);
+}
@@ -0,0 +1,90 @@
+#include <defs.h>
+#include <mailbox.h>
+#include <spr.h>
+#include <taskman/mailbox.h>
+
+__global static struct taskman_handler mailbox_handler;
+
+struct wait_data {
+    /// @brief Peer CPU id.
+    uint32_t cpu;
+
+    /// @brief CPU that called taskman_mailbox_send/recv, the one owning the task's end of the ring.
+    uint32_t self;
+
+    /// @brief Message to send, or received message.
+    mailbox_msg_t msg;
+
+    /// @brief 0 to receive, 1 to send.
+    int operation;
+};
+
+static inline __always_inline uint32_t cpu_id() {
+    return SPR_READ(9) & 0xF;
+}
+
+/*
+ * taskman calls on_wait and can_resume with TASKMAN_LOCK held. The rings
+ * take no lock of their own: they are single-producer single-consumer, and
+ * only the CPU that called send/recv touches the task's end of the ring, so
+ * the peer CPU (which may not run taskman at all) never waits on TASKMAN_LOCK.
+ * Another CPU evaluating can_resume for a task that is not pinned would use
+ * its own ring, hence the check of `self`.
+ */
+static int impl(struct wait_data* wait_data) {
+    if (wait_data->self != cpu_id())
+        return 0;
+
+    if (wait_data->operation == 0)
+        return mailbox_recv(wait_data->cpu, &wait_data->msg) == 0;
+
+    return mailbox_send(wait_data->cpu, wait_data->msg) == 0;
+}
+
+static int on_wait(struct taskman_handler* handler, void* stack, void* arg) {
+    UNUSED(handler);
+    UNUSED(stack);
+
+    return impl((struct wait_data*)arg);
+}
+
+static int can_resume(struct taskman_handler* handler, void* stack, void* arg) {
+    UNUSED(handler);
+    UNUSED(stack);
+
+    return impl((struct wait_data*)arg);
+}
+
+static void loop(struct taskman_handler* handler) {
+    UNUSED(handler);
+}
+
+void taskman_mailbox_glinit() {
+    mailbox_handler.name = "mailbox";
+    mailbox_handler.on_wait = &on_wait;
+    mailbox_handler.can_resume = &can_resume;
+    mailbox_handler.loop = &loop;
+
+    taskman_register(&mailbox_handler);
+}
+
+void __no_optimize taskman_mailbox_send(uint32_t dst, mailbox_msg_t msg) {
+    struct wait_data wait_data;
+    wait_data.cpu = dst;
+    wait_data.self = cpu_id();
+    wait_data.msg = msg;
+    wait_data.operation = 1;
+
+    taskman_wait(&mailbox_handler, &wait_data);
+}
+
+mailbox_msg_t __no_optimize taskman_mailbox_recv(uint32_t src) {
+    struct wait_data wait_data;
+    wait_data.cpu = src;
+    wait_data.self = cpu_id();
+    wait_data.operation = 0;
+
+    taskman_wait(&mailbox_handler, &wait_data);
+
+    return wait_data.msg;
+}
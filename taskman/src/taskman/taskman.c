@@ -2,8 +2,10 @@
 #include <cache.h>
 #include <defs.h>
 #include <locks.h>
+#include <perf.h>
 #include <taskman/taskman.h>
 #include <stdio.h>
+#include <trace.h>
 
 #include <implement_me.h>
 
@@ -18,6 +20,16 @@
 
 #define TASKMAN_LOCK_ID 2
 
+/// @brief Maximum number of CPUs (CPU ids are read from SPR 9).
+#define TASKMAN_NUM_CPUS 4
+
+/// @brief CPU id meaning "has not run yet".
+#define TASKMAN_CPU_NONE 0
+
+/// @brief A CPU steals a task from the CPU it last ran on only if that CPU
+/// owns more than this many tasks in excess of the stealing CPU.
+#define TASKMAN_AFFINITY_IMBALANCE 1
+
 #define TASKMAN_LOCK()             \
     do {                           \
         get_lock(TASKMAN_LOCK_ID); \
@@ -49,6 +61,12 @@ __global static struct {
 
     /// @brief True if the task manager should stop.
     uint32_t should_stop;
+
+    /// @brief 1 if the cache-warm rescheduling is enabled.
+    uint32_t affinity_enabled;
+
+    /// @brief Number of live tasks that last ran on each CPU.
+    uint32_t cpu_load[TASKMAN_NUM_CPUS];
 } taskman;
 
 /**
@@ -71,8 +89,84 @@ struct task_data {
     /// @brief 1 if running on some core, 0 otherwise.
     /// Prevents multiple cores from running the same task.
     int running_on_cpu;
+
+    struct {
+        /// @brief Scheduling policy.
+        enum taskman_affinity policy;
+
+        /// @brief CPUs the policy refers to.
+        uint32_t cpu_mask;
+
+        /// @brief CPU the task last ran on, `TASKMAN_CPU_NONE` if it never ran.
+        uint32_t last_cpu;
+    } affinity;
+
+    /// @brief Scheduling statistics.
+    struct taskman_stats stats;
 };
 
+__static_inline uint32_t cpu_id() {
+    return SPR_READ(9) & 0xF;
+}
+
+/**
+ * @brief Checks if the current CPU may steal a task from its last CPU.
+ * @note Must be called with the task manager lock held.
+ *
+ */
+static int can_steal(struct task_data* task_data, uint32_t cpu) {
+    uint32_t owner = task_data->affinity.last_cpu;
+
+    if (owner == TASKMAN_CPU_NONE)
+        return 1;
+
+    return taskman.cpu_load[owner] > taskman.cpu_load[cpu] + TASKMAN_AFFINITY_IMBALANCE;
+}
+
+/**
+ * @brief Checks if the task should be resumed on the current CPU.
+ * @note Must be called with the task manager lock held.
+ *
+ */
+static int can_run_here(struct task_data* task_data, uint32_t cpu) {
+    uint32_t in_mask = task_data->affinity.cpu_mask & TASKMAN_CPU_MASK(cpu);
+
+    switch (task_data->affinity.policy) {
+    case TASKMAN_AFFINITY_PINNED:
+        return in_mask != 0;
+
+    case TASKMAN_AFFINITY_PREFERRED:
+        if (!taskman.affinity_enabled || in_mask || task_data->affinity.last_cpu == cpu)
+            return 1;
+        return can_steal(task_data, cpu);
+
+    default:
+        if (!taskman.affinity_enabled || task_data->affinity.last_cpu == cpu)
+            return 1;
+        return can_steal(task_data, cpu);
+    }
+}
+
+/**
+ * @brief Moves the task to the current CPU.
+ * @note Must be called with the task manager lock held.
+ *
+ */
+static void attach_to(struct task_data* task_data, uint32_t cpu) {
+    uint32_t last_cpu = task_data->affinity.last_cpu;
+
+    if (last_cpu == cpu)
+        return;
+
+    if (last_cpu != TASKMAN_CPU_NONE) {
+        taskman.cpu_load[last_cpu]--;
+        task_data->stats.migrations++;
+    }
+
+    taskman.cpu_load[cpu]++;
+    task_data->affinity.last_cpu = cpu;
+}
+
 void taskman_glinit() {
     TASKMAN_LOCK();
 
@@ -80,6 +174,10 @@ void taskman_glinit() {
     taskman.stack_offset = 0;
     taskman.tasks_count = 0;
     taskman.should_stop = 0;
+    taskman.affinity_enabled = 1;
+
+    for (size_t i = 0; i < TASKMAN_NUM_CPUS; i++)
+        taskman.cpu_load[i] = 0;
 
     TASKMAN_RELEASE();
 }
@@ -114,6 +212,13 @@ void* taskman_spawn(coro_fn_t coro_fn, void* arg, size_t stack_sz) {
     task_data->running = 1;
     task_data->wait.arg = NULL;
     task_data->wait.handler = NULL;
+    task_data->running_on_cpu = 0;
+    task_data->affinity.policy = TASKMAN_AFFINITY_ANY;
+    task_data->affinity.cpu_mask = TASKMAN_CPU_MASK_ALL;
+    task_data->affinity.last_cpu = TASKMAN_CPU_NONE;
+    task_data->stats.resumes = 0;
+    task_data->stats.migrations = 0;
+    task_data->stats.events = 0;
 
     // (3) Register the coroutine in the tasks array (the coroutine's stack pointer in the array)
     taskman.tasks[taskman.tasks_count] = stack;
@@ -132,6 +237,9 @@ void taskman_loop() {
     //        * it yielded using `taskman_yield`.
     //        * the waiting handler says it can be resumed.
 
+    uint32_t cpu = cpu_id();
+    die_if_not(cpu < TASKMAN_NUM_CPUS);
+
     while (!taskman.should_stop) {
 
         TASKMAN_LOCK(); // Lock to run task handlers
@@ -174,6 +282,13 @@ void taskman_loop() {
                 continue;
             }
 
+            // Leave the task to its CPU, unless that one is overloaded.
+            // Must be checked before `can_resume`, which may consume a resource.
+            if (!can_run_here(task_data, cpu)) {
+                TASKMAN_RELEASE();
+                continue;
+            }
+
             // If there is a wait handler set by taskman_wait() (the task yielded)
             if(task_data->wait.handler){
                 // If the task is ready to be resumed
@@ -192,15 +307,23 @@ void taskman_loop() {
             // Set flag to prevent other cores from running the same motherfucking task
             // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
             task_data->running_on_cpu = 1;
+            attach_to(task_data, cpu);
 
             TASKMAN_RELEASE(); // Release to allow multiple cores to execute tasks in parallel
 
             // Every task that is coming here should be fine to resume
             // Resume the corresponding coroutine
+            perf_cycles_t events = perf_read_counter(TASKMAN_STATS_COUNTER);
+            trace_event(TRACE_TASK_RESUME, j);
             coro_resume(stack);
+            trace_event(TRACE_TASK_YIELD, j);
+            events = perf_read_counter(TASKMAN_STATS_COUNTER) - events;
 
             TASKMAN_LOCK();
 
+            task_data->stats.resumes++;
+            task_data->stats.events += events;
+
             // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
             // Reset this flag to allow for other cores to pickup on this task
             // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -210,6 +333,7 @@ void taskman_loop() {
             // this task should not be scheduled anymore and should be removed from taskman array
             if (coro_completed(stack, NULL)){
                 task_data->running = 0;
+                taskman.cpu_load[cpu]--;
             }
 
             TASKMAN_RELEASE();
@@ -225,6 +349,60 @@ void taskman_stop() {
     TASKMAN_RELEASE();
 }
 
+void taskman_set_affinity(void* stack, enum taskman_affinity affinity, uint32_t cpu_mask) {
+    TASKMAN_LOCK();
+
+    die_if_not(stack != NULL);
+    die_if_not(affinity == TASKMAN_AFFINITY_ANY || cpu_mask != 0);
+
+    struct task_data* task_data = (struct task_data*)coro_data(stack);
+    task_data->affinity.policy = affinity;
+    task_data->affinity.cpu_mask = affinity == TASKMAN_AFFINITY_ANY ? TASKMAN_CPU_MASK_ALL : cpu_mask;
+
+    TASKMAN_RELEASE();
+}
+
+void taskman_affinity_enable(int enable) {
+    TASKMAN_LOCK();
+
+    taskman.affinity_enabled = enable != 0;
+
+    TASKMAN_RELEASE();
+}
+
+void taskman_get_stats(void* stack, struct taskman_stats* stats) {
+    TASKMAN_LOCK();
+
+    die_if_not(stack != NULL);
+    die_if_not(stats != NULL);
+
+    *stats = ((struct task_data*)coro_data(stack))->stats;
+
+    TASKMAN_RELEASE();
+}
+
+void taskman_reset_stats() {
+    TASKMAN_LOCK();
+
+    for (size_t i = 0; i < taskman.tasks_count; i++) {
+        struct task_data* task_data = (struct task_data*)coro_data(taskman.tasks[i]);
+        task_data->stats.resumes = 0;
+        task_data->stats.migrations = 0;
+        task_data->stats.events = 0;
+    }
+
+    TASKMAN_RELEASE();
+}
+
+void taskman_trace_names() {
+    TASKMAN_LOCK();
+
+    for (size_t i = 0; i < taskman.handlers_count; i++)
+        trace_name(TRACE_TASK_WAIT, i, taskman.handlers[i]->name);
+
+    TASKMAN_RELEASE();
+}
+
 void taskman_register(struct taskman_handler* handler) {
     TASKMAN_LOCK();
 
@@ -258,6 +436,14 @@ void taskman_wait(struct taskman_handler* handler, void* arg) {
 
     int should_yield = !handler || !handler->on_wait || !handler->on_wait(handler, stack, arg);
 
+    if (trace_enabled) {
+        uint32_t index = TRACE_NO_HANDLER;
+        for (size_t i = 0; handler && i < taskman.handlers_count; i++)
+            if (taskman.handlers[i] == handler)
+                index = i;
+        trace_event(TRACE_TASK_WAIT, index);
+    }
+
     TASKMAN_RELEASE();
 
     // When we set the handler, this function should call on_wait to initialize some values 
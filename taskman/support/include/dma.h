@@ -1,15 +1,28 @@
 #ifndef __DMA_H__
 #define __DMA_H__
 
+#include <defs.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define DMA_BASE_ADDRESS 0x50000040
 
+/// @brief Start of the SPM, the same address for the CPU and the DMA.
+#define DMA_SPM_ADDRESS 0xC0000000
+
+/// @brief Bytes at the start of the SPM free for data. The SPM is 8 KB, its end holds the CPU stacks.
+#define DMA_SPM_DATA_SIZE 4096
+
 #define MEMORY_ADDRESS_ID 0
 #define SPM_ADDRESS_ID 1
 #define TRANSFER_SIZE_ID 2
 #define START_STATUS_ID 3
 
-#define DMA_FROM_SPM_TO_MEM 1 << 8
-#define DMA_FROM_MEM_TO_SPM 1 << 9
+#define DMA_FROM_SPM_TO_MEM (1 << 8)
+#define DMA_FROM_MEM_TO_SPM (1 << 9)
 
 #define DMA_BUSY_BIT 1
 #define DMA_ERROR_BIT 2
@@ -17,4 +30,136 @@
 #define DMA_SPM_ALLIGN_ERROR_BIT 8
 #define DMA_SPM_OUT_OF_RANGE_ERROR_BIT 16
 
+/// @brief Error bits of the status register.
+#define DMA_ERROR_MASK \
+    (DMA_ERROR_BIT | DMA_MEM_ALLIGN_ERROR_BIT | DMA_SPM_ALLIGN_ERROR_BIT | DMA_SPM_OUT_OF_RANGE_ERROR_BIT)
+
+/// @brief Burst size field of the start register.
+#define DMA_BURST_MASK 0xFF
+
+/// @brief Burst size used when a descriptor leaves it to 0.
+#define DMA_DEFAULT_BURST 0xFF
+
+enum dma_desc_state {
+    /** @brief Not submitted, or completed and reclaimed by its owner. */
+    DMA_DESC_IDLE,
+    /** @brief Waiting in the queue. */
+    DMA_DESC_QUEUED,
+    /** @brief Programmed in the DMA. */
+    DMA_DESC_ACTIVE,
+    /** @brief Completed, see `errors`. */
+    DMA_DESC_DONE,
+};
+
+/**
+ * @brief A transfer between the memory and the SPM.
+ *
+ * The descriptor belongs to the driver from `dma_submit` until it is done,
+ * its memory must stay valid until then.
+ *
+ */
+struct dma_desc {
+    /** @brief Memory address, word-aligned. */
+    void* mem;
+
+    /** @brief SPM address, word-aligned. */
+    uint32_t spm;
+
+    /** @brief Size of the transfer, in 32-bit words. */
+    uint32_t words;
+
+    /** @brief `DMA_FROM_SPM_TO_MEM` or `DMA_FROM_MEM_TO_SPM`. */
+    uint32_t direction;
+
+    /** @brief Burst size field, `DMA_DEFAULT_BURST` if 0. */
+    uint32_t burst;
+
+    /**
+     * @brief Called by the driver once the transfer is done, after the next
+     * queued transfer is started. May submit descriptors, may be NULL.
+     */
+    void (*on_done)(struct dma_desc* desc);
+
+    /** @brief Free for the owner, e.g. for `on_done`. */
+    void* arg;
+
+    /** @brief State, written by the driver. */
+    volatile enum dma_desc_state state;
+
+    /** @brief Error bits of the status register once done, 0 on success. */
+    volatile uint32_t errors;
+
+    /** @brief Next descriptor of the queue. */
+    struct dma_desc* next;
+};
+
+/**
+ * @brief Initializes a descriptor.
+ *
+ */
+__static_inline void dma_desc_init(struct dma_desc* desc, void* mem, uint32_t spm, uint32_t words, uint32_t direction) {
+    desc->mem = mem;
+    desc->spm = spm;
+    desc->words = words;
+    desc->direction = direction;
+    desc->burst = 0;
+    desc->on_done = NULL;
+    desc->arg = NULL;
+    desc->state = DMA_DESC_IDLE;
+    desc->errors = 0;
+    desc->next = NULL;
+}
+
+/**
+ * @brief Queues a transfer. It starts at once if the DMA is free, otherwise
+ * when the transfers queued before it are done.
+ *
+ * The transfers are chained by `dma_poll`: a queued transfer starts at the
+ * first call to `dma_poll` (or `dma_wait`) after the former one is done.
+ * The caches are not maintained: the caller flushes the data cache before a
+ * transfer reading memory the CPU wrote, and before reading memory written by
+ * a transfer.
+ *
+ * @note The driver is not shared between CPUs (its state is private to the CPU
+ * using it) and not reentrant: it must not be used by an interrupt handler and
+ * the code it interrupts. Under taskman, use it through `taskman/dma.h`.
+ *
+ * @param desc
+ */
+void dma_submit(struct dma_desc* desc);
+
+/**
+ * @brief Completes the active transfer if the DMA is done and starts the next one.
+ *
+ * @param desc Descriptor to check, NULL to check the whole queue.
+ * @return int 1 if `desc` is done (or idle), or if the queue is empty when `desc` is NULL.
+ */
+int dma_poll(struct dma_desc* desc);
+
+/**
+ * @brief Waits for a transfer.
+ *
+ * @param desc Descriptor to wait for, NULL to wait for the whole queue.
+ * @return uint32_t Error bits of `desc`, 0 if NULL.
+ */
+uint32_t dma_wait(struct dma_desc* desc);
+
+/**
+ * @brief Describes the error bits of a transfer.
+ *
+ * @param errors Error bits, e.g. `desc->errors`.
+ * @return const char* Most specific error, "none" if there are none.
+ */
+const char* dma_error_string(uint32_t errors);
+
+/**
+ * @brief Number of transfers done, and with errors, since the startup.
+ *
+ */
+void dma_stats(uint32_t* transfers, uint32_t* failures);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -0,0 +1,116 @@
+#ifndef MAILBOX_H_INCLUDED
+#define MAILBOX_H_INCLUDED
+
+#include <defs.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Maximum number of CPUs (CPU ids are read from SPR 9).
+#define MAILBOX_NUM_CPUS 4
+
+/// @brief Number of messages per ring. Must be a power of two.
+#define MAILBOX_CAPACITY 16
+
+/// @brief Alignment of the producer and consumer indices.
+/// Keeps them in distinct D$ lines so that the two CPUs do not invalidate each other.
+#define MAILBOX_LINE_SIZE 32
+
+typedef uint32_t mailbox_msg_t;
+
+/**
+ * @brief Single-producer single-consumer ring from one CPU to another.
+ *
+ * @note Indices are free-running, the ring holds `tail - head` messages.
+ *
+ */
+struct mailbox_ring {
+    /// @brief Written by the producer only.
+    struct {
+        /// @brief Index of the next slot to write.
+        volatile uint32_t tail;
+
+        /// @brief Last consumer index seen by the producer.
+        uint32_t head_cache;
+    } producer __aligned(MAILBOX_LINE_SIZE);
+
+    /// @brief Written by the consumer only.
+    struct {
+        /// @brief Index of the next slot to read.
+        volatile uint32_t head;
+
+        /// @brief Last producer index seen by the consumer.
+        uint32_t tail_cache;
+    } consumer __aligned(MAILBOX_LINE_SIZE);
+
+    /// @brief Messages.
+    volatile mailbox_msg_t data[MAILBOX_CAPACITY] __aligned(MAILBOX_LINE_SIZE);
+};
+
+/**
+ * @brief Initializes all the rings.
+ *
+ * @note Must be called once, before starting the other CPUs.
+ *
+ * @param doorbell 1 to ring the destination doorbell on each send, 0 otherwise.
+ */
+void mailbox_glinit(int doorbell);
+
+/**
+ * @brief Sends a message from the current CPU to `dst`, without blocking.
+ *
+ * @param dst Destination CPU id.
+ * @param msg Message.
+ * @return int 0 on success, -1 if the ring is full.
+ */
+int mailbox_send(uint32_t dst, mailbox_msg_t msg);
+
+/**
+ * @brief Receives a message sent by `src` to the current CPU, without blocking.
+ *
+ * @param src Source CPU id.
+ * @param msg Output message.
+ * @return int 0 on success, -1 if the ring is empty.
+ */
+int mailbox_recv(uint32_t src, mailbox_msg_t* msg);
+
+/**
+ * @brief Number of messages sent by `src` to the current CPU and not yet received.
+ *
+ * @param src Source CPU id.
+ * @return uint32_t
+ */
+uint32_t mailbox_pending(uint32_t src);
+
+/**
+ * @brief Reads and clears the doorbell of the current CPU.
+ *
+ * @note Clear the doorbell before draining the rings, so that no message is missed.
+ *
+ * @return uint32_t Mask of the source CPUs (bit `src`) that sent messages since the last call.
+ */
+uint32_t mailbox_doorbell();
+
+/**
+ * @brief Sends a message, spinning while the ring is full.
+ *
+ * @param dst Destination CPU id.
+ * @param msg Message.
+ */
+void mailbox_send_blocking(uint32_t dst, mailbox_msg_t msg);
+
+/**
+ * @brief Receives a message, spinning while the ring is empty.
+ *
+ * @param src Source CPU id.
+ * @return mailbox_msg_t
+ */
+mailbox_msg_t mailbox_recv_blocking(uint32_t src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAILBOX_H_INCLUDED */
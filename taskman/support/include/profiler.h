@@ -0,0 +1,90 @@
+#ifndef PROFILER_H_INCLUDED
+#define PROFILER_H_INCLUDED
+
+#include <defs.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Number of per-CPU histograms, indexed by the CPU id of SPR 9.
+#define PROFILER_CPUS 4
+
+#ifndef PROFILER_BUFFER_SIZE
+/// @brief Number of distinct PCs per CPU histogram. Must be a power of two.
+#define PROFILER_BUFFER_SIZE 1024
+#endif
+
+/// @brief Number of slots probed before a sample is dropped.
+#define PROFILER_MAX_PROBES 8
+
+/// @brief Default sampling period, in cycles.
+#define PROFILER_DEFAULT_PERIOD 10000
+
+/**
+ * @brief PC histogram of one CPU, filled by its tick timer handler.
+ *
+ */
+struct profiler_histogram {
+    /** @brief Sampled PCs, 0 for a free slot. */
+    uint32_t pcs[PROFILER_BUFFER_SIZE];
+
+    /** @brief Number of samples per PC. */
+    uint32_t counts[PROFILER_BUFFER_SIZE];
+
+    /** @brief Sampling period, in cycles. */
+    uint32_t period;
+
+    /** @brief Number of samples, dropped ones included. */
+    uint32_t samples;
+
+    /** @brief Number of samples dropped because the histogram was full. */
+    uint32_t dropped;
+
+    /** @brief Cycles from the timer match to the end of the handler, summed over the samples. */
+    uint64_t handler_cycles;
+};
+
+/**
+ * @brief Clears the histogram of the current CPU and starts sampling every `period` cycles.
+ *
+ * @note On CPU 1, the tick timer vector is redirected to `profiler_tick_handler`.
+ * On the other CPUs, `tick_timer_handler2`/`tick_timer_handler3` must call it.
+ *
+ * @note The crt0 exception handler stops the performance counters when it
+ * returns, do not combine sampling with `perf_start` measurements.
+ *
+ * @note The tick timer is reprogrammed: call `tick_glinit` after
+ * `profiler_stop` to restart the timestamps of `tick_value`.
+ *
+ * @param period Sampling period, in cycles.
+ */
+void profiler_start(uint32_t period);
+
+/**
+ * @brief Stops sampling on the current CPU.
+ *
+ * @note On CPU 1, the tick timer vector replaced by `profiler_start` is restored.
+ *
+ */
+void profiler_stop();
+
+/**
+ * @brief Records the interrupted PC and acknowledges the tick timer.
+ *
+ */
+void profiler_tick_handler();
+
+/**
+ * @brief Prints the histogram of a CPU, to be parsed by `support/tools/profile.py`.
+ *
+ * @param cpu CPU id, as read from SPR 9.
+ */
+void profiler_dump(unsigned cpu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROFILER_H_INCLUDED */
@@ -0,0 +1,143 @@
+#ifndef TRACE_H_INCLUDED
+#define TRACE_H_INCLUDED
+
+#include <defs.h>
+#include <stdint.h>
+#include <tick.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Number of per-CPU rings, indexed by the CPU id of SPR 9.
+#define TRACE_NUM_CPUS 4
+
+#ifndef TRACE_RING_SIZE
+/// @brief Number of events per ring. Must be a power of two.
+/// When a ring is full, the oldest events are overwritten.
+#define TRACE_RING_SIZE 1024
+#endif
+
+enum trace_event_id {
+    /// @brief A task is resumed, arg = task index.
+    TRACE_TASK_RESUME,
+
+    /// @brief A task returned control to the main loop, arg = task index.
+    TRACE_TASK_YIELD,
+
+    /// @brief A task waits, arg = handler index or `TRACE_NO_HANDLER`.
+    TRACE_TASK_WAIT,
+
+    /// @brief Started spinning on a lock, arg = lock id.
+    TRACE_LOCK_REQUEST,
+
+    /// @brief Acquired a lock, arg = lock id.
+    TRACE_LOCK_ACQUIRE,
+
+    /// @brief Released a lock, arg = lock id.
+    TRACE_LOCK_RELEASE,
+
+    /// @brief Entered an exception handler, arg = exception vector.
+    TRACE_EXCEPTION_ENTER,
+
+    /// @brief Left an exception handler, arg = exception vector.
+    TRACE_EXCEPTION_EXIT,
+
+    /// @brief First id available to the application.
+    TRACE_USER
+};
+
+/// @brief Argument of `TRACE_TASK_WAIT` for a plain yield.
+#define TRACE_NO_HANDLER 0xFFFFFFFF
+
+struct trace_event {
+    /// @brief Tick timer value, see `tick_value`.
+    uint32_t timestamp;
+    uint32_t id;
+    uint32_t arg;
+};
+
+struct trace_ring {
+    struct trace_event events[TRACE_RING_SIZE];
+
+    /// @brief Number of events recorded since the last reset, overwritten ones included.
+    uint32_t count;
+};
+
+extern struct trace_ring trace_rings[TRACE_NUM_CPUS];
+
+extern int trace_enabled;
+
+/**
+ * @brief Clears the rings and enables the tracing.
+ *
+ * @note Must be called once by CPU 1, after `tick_glinit`. The other CPUs
+ * must start their own tick timer with `tick_glinit`: the timers are not
+ * synchronized, timestamps of different CPUs are only roughly aligned.
+ *
+ */
+void trace_glinit();
+
+/**
+ * @brief Enables or disables the tracing on all CPUs.
+ *
+ * @param enable
+ */
+void trace_enable(int enable);
+
+/**
+ * @brief Records an event in the ring of the current CPU.
+ *
+ * @note Does not take any lock: each CPU only writes its own ring.
+ *
+ * @param id Event id.
+ * @param arg Event argument.
+ */
+__static_inline void trace_event(uint32_t id, uint32_t arg) {
+    if (!trace_enabled)
+        return;
+
+    struct trace_ring* ring = &trace_rings[SPR_READ(9) & 0xF];
+    struct trace_event* event = &ring->events[ring->count++ & (TRACE_RING_SIZE - 1)];
+    event->timestamp = tick_value();
+    event->id = id;
+    event->arg = arg;
+}
+
+/**
+ * @brief Called by the exception handlers, before the handler.
+ *
+ * @param vector Exception vector.
+ */
+void trace_exception_enter(uint32_t vector);
+
+/**
+ * @brief Called by the exception handlers, after the handler.
+ *
+ * @param vector Exception vector.
+ */
+void trace_exception_exit(uint32_t vector);
+
+/**
+ * @brief Prints a name for an event argument, e.g. the name of a wait handler.
+ * Names are used by `tools/trace2chrome.py`.
+ *
+ * @param id Event id.
+ * @param arg Event argument.
+ * @param name
+ */
+void trace_name(uint32_t id, uint32_t arg, const char* name);
+
+/**
+ * @brief Prints the rings of all CPUs, oldest events first.
+ *
+ * @note Disable the tracing beforehand, the output takes locks.
+ *
+ */
+void trace_dump();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H_INCLUDED */
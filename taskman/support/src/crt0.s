@@ -88,6 +88,9 @@ _exception_handler:
     l.sw        0x6C(r1),r29
     l.sw        0x70(r1),r30
     l.sw        0x74(r1),r31
+    l.mfspr     r3,r0,0x12
+    l.jal       trace_exception_enter
+    l.nop
     l.mfspr     r31,r0,0x12
     l.slli      r31,r31,2
     l.movhi     r30,hi(_vectors)
@@ -96,6 +99,9 @@ _exception_handler:
     l.lwz       r31,0x0(r30)
     l.jalr      r31
     l.nop
+    l.mfspr     r3,r0,0x12
+    l.jal       trace_exception_exit
+    l.nop
     l.lwz       r2,0x00(r1)
     l.lwz       r3,0x04(r1)
     l.lwz       r4,0x08(r1)
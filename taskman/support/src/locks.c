@@ -2,6 +2,7 @@
 #include <spr.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <trace.h>
 
 void init_locks() {
     uint8_t* locks = (uint8_t*)LOCKS_START_ADDRESS;
@@ -16,6 +17,7 @@ int get_lock(uint32_t lockId) {
     uint8_t* locks = (uint8_t*)LOCKS_START_ADDRESS;
     uint8_t res;
     uint8_t cpuId = SPR_READ(9) & 0xF;
+    trace_event(TRACE_LOCK_REQUEST, lockId);
     do {
         asm volatile(
             "l.cas %[out1],%[in1],%[in2],0" :
@@ -24,6 +26,7 @@ int get_lock(uint32_t lockId) {
             [in2] "r"(cpuId)
         );
     } while (res != cpuId);
+    trace_event(TRACE_LOCK_ACQUIRE, lockId);
     return 0;
 }
 
@@ -35,5 +38,6 @@ int release_lock(uint32_t lockId) {
     if (locks[lockId] != cpuId)
         return -1;
     locks[lockId] = 0;
+    trace_event(TRACE_LOCK_RELEASE, lockId);
     return 0;
 }
@@ -0,0 +1,113 @@
+#include <mailbox.h>
+#include <spr.h>
+
+/// @brief Compiler barrier. The CPU is in-order and the D$ coherent,
+/// so ordering the stores in program order is enough.
+#define MAILBOX_BARRIER() asm volatile("" ::: "memory")
+
+#define MAILBOX_MASK (MAILBOX_CAPACITY - 1)
+
+/// @brief Rings, indexed by [source CPU][destination CPU].
+__global static struct mailbox_ring rings[MAILBOX_NUM_CPUS][MAILBOX_NUM_CPUS];
+
+/// @brief Doorbells, indexed by [destination CPU][source CPU].
+/// Each byte is set by a single producer and cleared by a single consumer.
+__global static struct {
+    volatile uint8_t sources[MAILBOX_NUM_CPUS];
+} doorbells[MAILBOX_NUM_CPUS] __aligned(MAILBOX_LINE_SIZE);
+
+__global static int doorbell_enabled;
+
+static inline __always_inline uint32_t cpu_id() {
+    return SPR_READ(9) & 0xF;
+}
+
+void mailbox_glinit(int doorbell) {
+    for (int src = 0; src < MAILBOX_NUM_CPUS; src++) {
+        for (int dst = 0; dst < MAILBOX_NUM_CPUS; dst++) {
+            struct mailbox_ring* ring = &rings[src][dst];
+            ring->producer.tail = 0;
+            ring->producer.head_cache = 0;
+            ring->consumer.head = 0;
+            ring->consumer.tail_cache = 0;
+            doorbells[dst].sources[src] = 0;
+        }
+    }
+
+    doorbell_enabled = doorbell;
+}
+
+int mailbox_send(uint32_t dst, mailbox_msg_t msg) {
+    uint32_t src = cpu_id();
+    struct mailbox_ring* ring = &rings[src][dst];
+    uint32_t tail = ring->producer.tail;
+
+    // only read the consumer line when the cached index says the ring is full
+    if (tail - ring->producer.head_cache == MAILBOX_CAPACITY) {
+        ring->producer.head_cache = ring->consumer.head;
+        if (tail - ring->producer.head_cache == MAILBOX_CAPACITY)
+            return -1;
+    }
+
+    ring->data[tail & MAILBOX_MASK] = msg;
+    MAILBOX_BARRIER();
+    ring->producer.tail = tail + 1;
+
+    if (doorbell_enabled) {
+        MAILBOX_BARRIER();
+        doorbells[dst].sources[src] = 1;
+    }
+
+    return 0;
+}
+
+int mailbox_recv(uint32_t src, mailbox_msg_t* msg) {
+    struct mailbox_ring* ring = &rings[src][cpu_id()];
+    uint32_t head = ring->consumer.head;
+
+    // only read the producer line when the cached index says the ring is empty
+    if (head == ring->consumer.tail_cache) {
+        ring->consumer.tail_cache = ring->producer.tail;
+        if (head == ring->consumer.tail_cache)
+            return -1;
+    }
+
+    MAILBOX_BARRIER();
+    *msg = ring->data[head & MAILBOX_MASK];
+    MAILBOX_BARRIER();
+    ring->consumer.head = head + 1;
+
+    return 0;
+}
+
+uint32_t mailbox_pending(uint32_t src) {
+    struct mailbox_ring* ring = &rings[src][cpu_id()];
+    return ring->producer.tail - ring->consumer.head;
+}
+
+uint32_t mailbox_doorbell() {
+    uint32_t mask = 0;
+    uint32_t dst = cpu_id();
+
+    for (uint32_t src = 0; src < MAILBOX_NUM_CPUS; src++) {
+        if (doorbells[dst].sources[src]) {
+            doorbells[dst].sources[src] = 0;
+            mask |= 1 << src;
+        }
+    }
+
+    MAILBOX_BARRIER();
+    return mask;
+}
+
+void mailbox_send_blocking(uint32_t dst, mailbox_msg_t msg) {
+    while (mailbox_send(dst, msg))
+        ;
+}
+
+mailbox_msg_t mailbox_recv_blocking(uint32_t src) {
+    mailbox_msg_t msg;
+    while (mailbox_recv(src, &msg))
+        ;
+    return msg;
+}
@@ -0,0 +1,51 @@
+#include <perf.h>
+#include <stdio.h>
+#include <trace.h>
+
+__global struct trace_ring trace_rings[TRACE_NUM_CPUS];
+
+__global int trace_enabled;
+
+void trace_glinit() {
+    for (int cpu = 0; cpu < TRACE_NUM_CPUS; cpu++)
+        trace_rings[cpu].count = 0;
+
+    trace_enabled = 1;
+}
+
+void trace_enable(int enable) {
+    trace_enabled = enable;
+}
+
+void trace_exception_enter(uint32_t vector) {
+    trace_event(TRACE_EXCEPTION_ENTER, vector);
+}
+
+void trace_exception_exit(uint32_t vector) {
+    trace_event(TRACE_EXCEPTION_EXIT, vector);
+}
+
+void trace_name(uint32_t id, uint32_t arg, const char* name) {
+    printf("trace_name,%u,%u,%s\n", id, arg, name);
+}
+
+void trace_dump() {
+    printf("trace,freq_khz=%u,period=%u\n", perf_cpu_freq(), TICK_TICKS_PERIOD);
+
+    for (int cpu = 0; cpu < TRACE_NUM_CPUS; cpu++) {
+        struct trace_ring* ring = &trace_rings[cpu];
+        uint32_t count = ring->count;
+        uint32_t first = count > TRACE_RING_SIZE ? count - TRACE_RING_SIZE : 0;
+
+        if (count == 0)
+            continue;
+
+        printf("trace_cpu,%d,%u,%u\n", cpu, count - first, first);
+        for (uint32_t i = first; i < count; i++) {
+            struct trace_event* event = &ring->events[i & (TRACE_RING_SIZE - 1)];
+            printf("%08X %u %u\n", event->timestamp, event->id, event->arg);
+        }
+    }
+
+    printf("trace_end\n");
+}
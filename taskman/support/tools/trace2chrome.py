@@ -0,0 +1,165 @@
+"""
+Converts the output of `trace_dump` to the Chrome trace event format.
+
+usage:
+    python3 trace2chrome.py <capture.txt> [--out trace.json]
+
+Open the result in chrome://tracing or https://ui.perfetto.dev. Each CPU is a
+process with one track per category: tasks, locks and exceptions.
+
+The capture is the raw UART output; lines outside of the trace are ignored.
+The tick timers of the CPUs are not synchronized: the timeline of each CPU
+starts at its first event.
+"""
+
+import argparse
+import dataclasses
+import json
+import pathlib
+from typing import *
+
+# see `enum trace_event_id` in trace.h
+TASK_RESUME = 0
+TASK_YIELD = 1
+TASK_WAIT = 2
+LOCK_REQUEST = 3
+LOCK_ACQUIRE = 4
+LOCK_RELEASE = 5
+EXCEPTION_ENTER = 6
+EXCEPTION_EXIT = 7
+
+NO_HANDLER = 0xFFFFFFFF
+
+EXCEPTIONS = ["reset", "bus_error", "data_page_fault", "instruction_page_fault", "tick_timer",
+              "alignment", "illegal_instruction", "external_interrupt", "dtlb_miss", "itlb_miss",
+              "range", "system_call", "break_point", "trap"]
+
+TRACKS = {"tasks": 1, "locks": 2, "exceptions": 3}
+
+
+@dataclasses.dataclass
+class Event:
+    timestamp: int
+    id: int
+    arg: int
+
+
+@dataclasses.dataclass
+class Trace:
+    freq_khz: int = 0
+    period: int = 0xFFFFFFF
+    names: Dict[Tuple[int, int], str] = dataclasses.field(default_factory=dict)
+    cpus: Dict[int, List[Event]] = dataclasses.field(default_factory=dict)
+    dropped: Dict[int, int] = dataclasses.field(default_factory=dict)
+
+
+def load_trace(fpath: pathlib.Path) -> Trace:
+    trace = Trace()
+    events: Optional[List[Event]] = None
+
+    with open(fpath, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+
+            if line.startswith("trace,"):
+                fields = dict(item.split("=") for item in line.split(",")[1:])
+                trace.freq_khz = int(fields["freq_khz"])
+                trace.period = int(fields["period"])
+            elif line.startswith("trace_name,"):
+                _, id, arg, name = line.split(",", 3)
+                trace.names[(int(id), int(arg))] = name
+            elif line.startswith("trace_cpu,"):
+                _, cpu, _, first = line.split(",")
+                events = trace.cpus.setdefault(int(cpu), [])
+                trace.dropped[int(cpu)] = int(first)
+            elif line == "trace_end":
+                events = None
+            elif events is not None:
+                fields = line.split()
+                if len(fields) == 3:
+                    events.append(Event(int(fields[0], 16), int(fields[1]), int(fields[2])))
+
+    if trace.freq_khz == 0:
+        raise ValueError(f"{fpath}: no trace header")
+    return trace
+
+
+def unwrap(events: List[Event], period: int) -> List[int]:
+    """Timestamps in cycles since the first event, the tick timer restarts at `period`."""
+    cycles = []
+    offset = 0
+    for i, event in enumerate(events):
+        if i and event.timestamp < events[i - 1].timestamp:
+            offset += period + 1
+        cycles.append(offset + event.timestamp - events[0].timestamp)
+    return cycles
+
+
+def convert(trace: Trace) -> List[Dict[str, Any]]:
+    out: List[Dict[str, Any]] = []
+
+    for cpu, events in sorted(trace.cpus.items()):
+        out.append({"name": "process_name", "ph": "M", "pid": cpu, "args": {"name": f"CPU {cpu}"}})
+        for track, tid in TRACKS.items():
+            out.append({"name": "thread_name", "ph": "M", "pid": cpu, "tid": tid, "args": {"name": track}})
+        if not events:
+            continue
+
+        def us(cycles: int) -> float:
+            return cycles * 1000 / trace.freq_khz
+
+        def span(name: str, track: str, begin: int, end: int, **args: Any) -> None:
+            out.append({"name": name, "cat": track, "ph": "X", "pid": cpu, "tid": TRACKS[track],
+                        "ts": us(begin), "dur": us(end) - us(begin), "args": args})
+
+        resumed: Dict[int, int] = {}
+        requested: Dict[int, int] = {}
+        acquired: Dict[int, int] = {}
+        entered: Dict[int, int] = {}
+
+        for event, cycles in zip(events, unwrap(events, trace.period)):
+            if event.id == TASK_RESUME:
+                resumed[event.arg] = cycles
+            elif event.id == TASK_YIELD and event.arg in resumed:
+                span(f"task {event.arg}", "tasks", resumed.pop(event.arg), cycles, task=event.arg)
+            elif event.id == TASK_WAIT:
+                name = "yield" if event.arg == NO_HANDLER else \
+                    trace.names.get((TASK_WAIT, event.arg), f"handler {event.arg}")
+                out.append({"name": f"wait {name}", "cat": "tasks", "ph": "i", "s": "t", "pid": cpu,
+                            "tid": TRACKS["tasks"], "ts": us(cycles)})
+            elif event.id == LOCK_REQUEST:
+                requested[event.arg] = cycles
+            elif event.id == LOCK_ACQUIRE:
+                if event.arg in requested:
+                    span(f"spin lock {event.arg}", "locks", requested.pop(event.arg), cycles, lock=event.arg)
+                acquired[event.arg] = cycles
+            elif event.id == LOCK_RELEASE and event.arg in acquired:
+                span(f"hold lock {event.arg}", "locks", acquired.pop(event.arg), cycles, lock=event.arg)
+            elif event.id == EXCEPTION_ENTER:
+                entered[event.arg] = cycles
+            elif event.id == EXCEPTION_EXIT and event.arg in entered:
+                name = EXCEPTIONS[event.arg] if event.arg < len(EXCEPTIONS) else f"exception {event.arg}"
+                span(name, "exceptions", entered.pop(event.arg), cycles, vector=event.arg)
+            elif event.id > EXCEPTION_EXIT:
+                name = trace.names.get((event.id, event.arg), f"event {event.id}")
+                out.append({"name": name, "cat": "user", "ph": "i", "s": "p", "pid": cpu,
+                            "ts": us(cycles), "args": {"arg": event.arg}})
+
+    return out
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="trace_dump to Chrome trace event format")
+    parser.add_argument("capture", type=pathlib.Path, help="UART output containing a trace_dump")
+    parser.add_argument("--out", type=pathlib.Path, default=pathlib.Path("trace.json"))
+    args = parser.parse_args()
+
+    trace = load_trace(args.capture)
+    out = convert(trace)
+
+    with open(args.out, "w") as f:
+        json.dump({"traceEvents": out, "displayTimeUnit": "ns"}, f)
+
+    for cpu, events in sorted(trace.cpus.items()):
+        print(f"CPU {cpu}: {len(events)} events, {trace.dropped[cpu]} overwritten")
+    print(f"{args.out}: {len(out)} trace events")